@@ -0,0 +1,249 @@
+// ------------------------- OpenPose Library Tests - CPU Kernels -------------------------
+// Regression test of the CPU counterparts of the CUDA kernels of the `core` module: resizeAndMergeCpu, nmsCpu and
+// maximumCpu. The float versions (vectorized when compiled with SSE2, AVX or AVX2) are compared against:
+    // 1. Naive scalar references written here, one output element at a time
+    // 2. The double versions of the same kernels, which always run their scalar code
+// The sizes are odd on purpose, so every vector loop also runs its remainder. It returns 0 if every check passes.
+
+// C++ std library dependencies
+#include <algorithm> // std::max, std::min
+#include <array>
+#include <cmath> // std::abs
+#include <random>
+#include <string>
+#include <vector>
+// OpenPose dependencies
+#include <openpose/core/maximumBase.hpp>
+#include <openpose/core/nmsBase.hpp>
+#include <openpose/core/resizeAndMergeBase.hpp>
+#include <openpose/utilities/errorAndLog.hpp>
+
+namespace
+{
+    int numberFailures = 0;
+
+    void expect(const bool condition, const std::string& message)
+    {
+        if (!condition)
+        {
+            numberFailures++;
+            op::log("FAILED: " + message, op::Priority::High);
+        }
+    }
+
+    std::vector<float> getRandomVector(const int size, std::mt19937& randomEngine, const float minimum = 0.f,
+                                       const float maximum = 1.f)
+    {
+        std::uniform_real_distribution<float> distribution{minimum, maximum};
+        std::vector<float> values(size);
+        for (auto& value : values)
+            value = distribution(randomEngine);
+        return values;
+    }
+
+    // resizeAndMergeCpu, one target pixel at a time: bilinear sample of each scale (centers aligned, clamped to the
+    // borders), averaged over the scales
+    double resizeAndMergeReference(const std::vector<float>& source, const std::array<int, 4>& targetSize,
+                                   const std::array<int, 4>& sourceSize, const std::vector<float>& scales,
+                                   const int c, const int y, const int x)
+    {
+        const auto numberScales = sourceSize[0];
+        auto sum = 0.;
+        for (auto n = 0 ; n < numberScales ; n++)
+        {
+            const auto scaleRatio = (numberScales > 1 ? (double)scales[n] / scales[0] : 1.);
+            const auto sample = [](const int target, const int targetLength, const int sourceLength,
+                                   const double ratio, int& index0, int& index1, double& weight)
+            {
+                const auto coordinate = std::max(0., (target + 0.5) * ratio * sourceLength / targetLength - 0.5);
+                index0 = std::min((int)coordinate, sourceLength - 1);
+                index1 = std::min(index0 + 1, sourceLength - 1);
+                weight = (index0 < sourceLength - 1 ? coordinate - index0 : 0.);
+            };
+            int x0, x1, y0, y1;
+            double xWeight, yWeight;
+            sample(x, targetSize[3], sourceSize[3], scaleRatio, x0, x1, xWeight);
+            sample(y, targetSize[2], sourceSize[2], scaleRatio, y0, y1, yWeight);
+            const auto* const channelPtr = &source[((n * sourceSize[1] + c) * sourceSize[2]) * sourceSize[3]];
+            const auto value = [&](const int yy, const int xx) { return (double)channelPtr[yy * sourceSize[3] + xx]; };
+            const auto top = value(y0, x0) + xWeight * (value(y0, x1) - value(y0, x0));
+            const auto bottom = value(y1, x0) + xWeight * (value(y1, x1) - value(y1, x0));
+            sum += top + yWeight * (bottom - top);
+        }
+        return sum / numberScales;
+    }
+
+    void testResizeAndMerge(std::mt19937& randomEngine, const std::array<int, 4>& targetSize,
+                            const std::array<int, 4>& sourceSize, const std::vector<float>& scales)
+    {
+        const auto name = "resizeAndMergeCpu " + std::to_string(sourceSize[3]) + "x" + std::to_string(sourceSize[2])
+                        + " -> " + std::to_string(targetSize[3]) + "x" + std::to_string(targetSize[2]) + ", "
+                        + std::to_string(sourceSize[0]) + " scale(s)";
+        const auto source = getRandomVector(sourceSize[0] * sourceSize[1] * sourceSize[2] * sourceSize[3],
+                                            randomEngine, -1.f, 1.f);
+        const auto targetVolume = targetSize[1] * targetSize[2] * targetSize[3];
+        std::vector<float> target(targetVolume);
+        op::resizeAndMergeCpu(target.data(), source.data(), targetSize, sourceSize, scales);
+        const std::vector<double> sourceDouble(source.begin(), source.end());
+        std::vector<double> targetDouble(targetVolume);
+        op::resizeAndMergeCpu(targetDouble.data(), sourceDouble.data(), targetSize, sourceSize,
+                              std::vector<double>(scales.begin(), scales.end()));
+        auto maximumErrorReference = 0.;
+        auto maximumErrorDouble = 0.;
+        for (auto c = 0 ; c < targetSize[1] ; c++)
+            for (auto y = 0 ; y < targetSize[2] ; y++)
+                for (auto x = 0 ; x < targetSize[3] ; x++)
+                {
+                    const auto index = (c * targetSize[2] + y) * targetSize[3] + x;
+                    const auto reference = resizeAndMergeReference(source, targetSize, sourceSize, scales, c, y, x);
+                    maximumErrorReference = std::max(maximumErrorReference, std::abs(target[index] - reference));
+                    maximumErrorDouble = std::max(maximumErrorDouble, std::abs(target[index] - targetDouble[index]));
+                }
+        expect(maximumErrorReference < 1e-5, name + ": error against the reference " +
+               std::to_string(maximumErrorReference));
+        expect(maximumErrorDouble < 1e-5, name + ": error against the double version " +
+               std::to_string(maximumErrorDouble));
+    }
+
+    // nmsCpu, one pixel at a time: above threshold and strictly greater than its in-bounds 3x3 neighbours
+    bool isPeakReference(const float* const channelPtr, const int width, const int height, const int x, const int y,
+                         const float threshold)
+    {
+        const auto value = channelPtr[y * width + x];
+        if (value <= threshold)
+            return false;
+        for (auto yy = std::max(0, y-1) ; yy <= std::min(height-1, y+1) ; yy++)
+            for (auto xx = std::max(0, x-1) ; xx <= std::min(width-1, x+1) ; xx++)
+                if ((xx != x || yy != y) && value <= channelPtr[yy * width + xx])
+                    return false;
+        return true;
+    }
+
+    void testNms(std::mt19937& randomEngine, const int width, const int height, const int maxPeaks)
+    {
+        const auto name = "nmsCpu " + std::to_string(width) + "x" + std::to_string(height) + ", "
+                        + std::to_string(maxPeaks) + " peaks max";
+        const auto threshold = 0.5f;
+        const std::array<int, 4> sourceSize{2, 3, height, width};
+        const std::array<int, 4> targetSize{2, 3, maxPeaks + 1, 3};
+        const auto source = getRandomVector(sourceSize[0] * sourceSize[1] * height * width, randomEngine);
+        const auto targetVolume = targetSize[0] * targetSize[1] * targetSize[2] * targetSize[3];
+        std::vector<float> target(targetVolume);
+        op::nmsCpu(target.data(), (int*)nullptr, source.data(), threshold, targetSize, sourceSize);
+        const std::vector<double> sourceDouble(source.begin(), source.end());
+        std::vector<double> targetDouble(targetVolume);
+        op::nmsCpu(targetDouble.data(), (int*)nullptr, sourceDouble.data(), (double)threshold, targetSize,
+                   sourceSize);
+        for (auto index = 0 ; index < targetSize[0] * targetSize[1] ; index++)
+        {
+            const auto* const channelPtr = &source[index * height * width];
+            const auto* const peaksPtr = &target[index * targetSize[2] * 3];
+            const auto* const peaksDoublePtr = &targetDouble[index * targetSize[2] * 3];
+            // Peaks in row-major order, as many as fit
+            std::vector<float> referenceScores;
+            for (auto y = 0 ; y < height ; y++)
+                for (auto x = 0 ; x < width ; x++)
+                    if ((int)referenceScores.size() < maxPeaks
+                        && isPeakReference(channelPtr, width, height, x, y, threshold))
+                        referenceScores.emplace_back(channelPtr[y * width + x]);
+            const auto numberPeaks = (int)peaksPtr[0];
+            expect(numberPeaks == (int)referenceScores.size(), name + ": " + std::to_string(numberPeaks)
+                   + " peaks instead of " + std::to_string(referenceScores.size()));
+            expect(numberPeaks == (int)peaksDoublePtr[0], name + ": different number of peaks than the double version");
+            if (numberPeaks != (int)referenceScores.size() || numberPeaks != (int)peaksDoublePtr[0])
+                continue;
+            for (auto peak = 1 ; peak <= numberPeaks ; peak++)
+            {
+                expect(peaksPtr[3*peak+2] == referenceScores[peak-1], name + ": wrong score of peak "
+                       + std::to_string(peak));
+                expect(std::abs(peaksPtr[3*peak] - peaksDoublePtr[3*peak]) < 1e-4
+                       && std::abs(peaksPtr[3*peak+1] - peaksDoublePtr[3*peak+1]) < 1e-4,
+                       name + ": subpixel location of peak " + std::to_string(peak)
+                       + " differs from the double version");
+            }
+        }
+    }
+
+    void testNmsHandChecked()
+    {
+        // 5x4 map with a single peak at (3, 2), the rest below threshold except a plateau of 2 equal pixels (no peak)
+        const auto width = 5;
+        const auto height = 4;
+        std::vector<float> source(width * height, 0.f);
+        source[2 * width + 3] = 0.9f;
+        source[2 * width + 2] = 0.3f; // Left neighbour, weighs on the subpixel refinement
+        source[0] = 0.6f;
+        source[1] = 0.6f;
+        const std::array<int, 4> sourceSize{1, 1, height, width};
+        const std::array<int, 4> targetSize{1, 1, 4, 3};
+        std::vector<float> target(12, -1.f);
+        op::nmsCpu(target.data(), (int*)nullptr, source.data(), 0.5f, targetSize, sourceSize);
+        expect(target[0] == 1.f, "nmsCpu hand-checked: the plateau must not be a peak");
+        expect(std::abs(target[3] - (3.f * 0.9f + 2.f * 0.3f + 0.6f) / 2.4f) < 1e-6f
+               && std::abs(target[4] - (2.f * 1.2f + 0.f * 1.2f) / 2.4f) < 1e-6f && target[5] == 0.9f,
+               "nmsCpu hand-checked: wrong peak (x, y, score)");
+    }
+
+    void testMaximum(std::mt19937& randomEngine, const int width, const int height)
+    {
+        const auto name = "maximumCpu " + std::to_string(width) + "x" + std::to_string(height);
+        const std::array<int, 4> sourceSize{3, 6, height, width};
+        const std::array<int, 4> targetSize{3, 5, 3, 1}; // Background channel not scanned
+        const auto channelVolume = width * height;
+        auto source = getRandomVector(sourceSize[0] * sourceSize[1] * channelVolume, randomEngine);
+        // Ties in odd channels: the same maximum in 2 different vector lanes and in the last element, the first one
+        // must be kept
+        for (auto channel = 1 ; channel < sourceSize[0] * sourceSize[1] ; channel += 2)
+        {
+            auto* const channelPtr = &source[channel * channelVolume];
+            channelPtr[5] = 2.f;
+            channelPtr[10] = 2.f;
+            channelPtr[channelVolume - 1] = 2.f;
+        }
+        std::vector<float> target(targetSize[0] * targetSize[1] * 3);
+        op::maximumCpu(target.data(), source.data(), targetSize, sourceSize);
+        for (auto n = 0 ; n < targetSize[0] ; n++)
+            for (auto c = 0 ; c < targetSize[1] ; c++)
+            {
+                const auto* const channelPtr = &source[(n * sourceSize[1] + c) * channelVolume];
+                // std::max_element returns the first maximum
+                const auto maximumIndex = (int)(std::max_element(channelPtr, channelPtr + channelVolume) - channelPtr);
+                const auto* const keypointPtr = &target[3 * (n * targetSize[1] + c)];
+                expect(keypointPtr[0] == float(maximumIndex % width) && keypointPtr[1] == float(maximumIndex / width)
+                       && keypointPtr[2] == channelPtr[maximumIndex],
+                       name + ": wrong maximum of person " + std::to_string(n) + ", channel " + std::to_string(c));
+            }
+    }
+}
+
+int cpuKernelsTest()
+{
+    op::log("OpenPose Library Tests - CPU Kernels.", op::Priority::High);
+    std::mt19937 randomEngine{2017u};
+    // resizeAndMergeCpu: 1 and 2 scales, then a smaller target (the row caches of each thread are reused)
+    testResizeAndMerge(randomEngine, {1, 5, 93, 123}, {1, 5, 12, 16}, {1.f});
+    testResizeAndMerge(randomEngine, {1, 5, 93, 123}, {2, 5, 12, 16}, {1.f, 0.7f});
+    testResizeAndMerge(randomEngine, {1, 3, 37, 45}, {3, 3, 10, 13}, {1.f, 0.75f, 0.5f});
+    // nmsCpu: rows wider and narrower than a vector (41 = 1 + a multiple of the vector width, so the last vector
+    // would end on the border column), and a peak limit reached before the end of the map
+    testNms(randomEngine, 45, 31, 400);
+    testNms(randomEngine, 41, 31, 400);
+    testNms(randomEngine, 5, 7, 400);
+    testNms(randomEngine, 45, 31, 20);
+    testNmsHandChecked();
+    // maximumCpu: channels longer and shorter than 2 vectors (the short ones use the scalar scan)
+    testMaximum(randomEngine, 37, 29);
+    testMaximum(randomEngine, 3, 4);
+    if (numberFailures > 0)
+    {
+        op::log(std::to_string(numberFailures) + " check(s) failed.", op::Priority::High);
+        return -1;
+    }
+    op::log("CPU kernels test successfully finished.", op::Priority::High);
+    return 0;
+}
+
+int main()
+{
+    return cpuKernelsTest();
+}
@@ -0,0 +1,148 @@
+// ------------------------- OpenPose Library Tests - Float To Half -------------------------
+// Regression test of the float16 heat map conversion (tutorial_pose/dllExport/heatMapConversion.hpp):
+    // 1. floatToHalf on every float (compiled with F16C: all 2^32 of them against the hardware conversion) or on every
+    //    exponent and upper mantissa with the rounding-relevant lower mantissas (without F16C: against the definition,
+    //    i.e. the nearest half, ties to even, overflow to infinity, NaN kept as NaN)
+    // 2. convertToHalf (F16C blocks of 8 if available) against floatToHalf, for every block remainder
+// It returns 0 if every check passes.
+
+// C++ std library dependencies
+#include <cmath> // std::abs, std::ldexp
+#include <cstring> // std::memcpy
+#include <limits>
+#include <string>
+#include <vector>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "../tutorial_pose/dllExport/heatMapConversion.hpp"
+
+namespace
+{
+    int numberFailures = 0;
+
+    void expect(const bool condition, const std::string& message)
+    {
+        if (!condition)
+        {
+            numberFailures++;
+            op::log("FAILED: " + message, op::Priority::High);
+        }
+    }
+
+    float bitsToFloat(const unsigned int bits)
+    {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Value of a finite half magnitude (0 to 0x7bff)
+    double halfMagnitudeToDouble(const unsigned int magnitude)
+    {
+        const auto exponent = (int)(magnitude >> 10);
+        const auto mantissa = (double)(magnitude & 0x3ffu);
+        return (exponent == 0 ? std::ldexp(mantissa, -24) : std::ldexp(1024. + mantissa, exponent - 25));
+    }
+
+    // floatToHalf(value) == half according to the definition of binary16 rounding
+    bool isCorrectHalf(const float value, const unsigned short half)
+    {
+        unsigned int bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        if ((half & 0x8000u) != ((bits >> 16) & 0x8000u))
+            return false;
+        const auto magnitude = half & 0x7fffu;
+        const auto absoluteValue = std::abs((double)value);
+        if (value != value)
+            return magnitude > 0x7c00u;
+        // 65520 = 65504 (largest half) + half its last step: rounds to infinity
+        if (absoluteValue >= 65520.)
+            return magnitude == 0x7c00u;
+        if (magnitude >= 0x7c00u)
+            return false;
+        // Nearest, ties to even
+        const auto distance = std::abs(absoluteValue - halfMagnitudeToDouble(magnitude));
+        for (const auto neighbour : {(int)magnitude - 1, (int)magnitude + 1})
+        {
+            if (neighbour < 0 || neighbour > 0x7bff)
+                continue;
+            const auto neighbourDistance = std::abs(absoluteValue - halfMagnitudeToDouble((unsigned int)neighbour));
+            if (neighbourDistance < distance || (neighbourDistance == distance && (magnitude & 1u)))
+                return false;
+        }
+        return true;
+    }
+
+    void testFloatToHalf()
+    {
+        auto numberWrong = 0ull;
+        auto numberTested = 0ull;
+        #ifdef OPENPOSE_DLL_EXPORT_F16C
+            for (auto bits = 0ull ; bits <= 0xffffffffull ; bits++)
+            {
+                const auto value = bitsToFloat((unsigned int)bits);
+                const auto half = dllExport::floatToHalf(value);
+                const auto reference = (unsigned short)_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT);
+                // F16C keeps the NaN payload, floatToHalf only has to keep a NaN
+                if (value != value ? !isCorrectHalf(value, half) : half != reference)
+                    numberWrong++;
+                numberTested++;
+            }
+        #else
+            // The 19 upper bits (sign, exponent and upper mantissa, i.e. every half rounding position) with the lower
+            // mantissas around their halfway points
+            for (auto upperBits = 0u ; upperBits < (1u << 19) ; upperBits++)
+            {
+                for (const auto lowerBits : {0x0u, 0x1u, 0xfffu, 0x1000u, 0x1001u, 0x1fffu})
+                {
+                    const auto value = bitsToFloat((upperBits << 13) | lowerBits);
+                    if (!isCorrectHalf(value, dllExport::floatToHalf(value)))
+                        numberWrong++;
+                    numberTested++;
+                }
+            }
+        #endif
+        expect(numberWrong == 0ull, "floatToHalf: " + std::to_string(numberWrong) + " of "
+               + std::to_string(numberTested) + " floats wrongly converted");
+        op::log("floatToHalf: " + std::to_string(numberTested) + " floats checked.", op::Priority::High);
+    }
+
+    void testConvertToHalf()
+    {
+        const std::vector<float> specialValues{0.f, -0.f, 1.f, -2.5f, 65504.f, 65520.f, 1e-8f, 6.1e-5f,
+                                               std::numeric_limits<float>::infinity(), 0.333333f, -1e5f, 0.1f};
+        for (auto size = 0 ; size <= 33 ; size++)
+        {
+            std::vector<float> source(size);
+            for (auto i = 0 ; i < size ; i++)
+                source[i] = specialValues[i % specialValues.size()] * (i % 3 == 2 ? -1.f : 1.f);
+            // The extra element must never be written
+            std::vector<unsigned short> target(size + 1, 0xabcdu);
+            dllExport::convertToHalf(target.data(), source.data(), size);
+            auto isConverted = (target.back() == 0xabcdu);
+            for (auto i = 0 ; i < size ; i++)
+                isConverted &= (target[i] == dllExport::floatToHalf(source[i]));
+            expect(isConverted, "convertToHalf of " + std::to_string(size) + " floats");
+        }
+    }
+}
+
+int floatToHalfTest()
+{
+    op::log("OpenPose Library Tests - Float To Half.", op::Priority::High);
+    testFloatToHalf();
+    testConvertToHalf();
+    if (numberFailures > 0)
+    {
+        op::log(std::to_string(numberFailures) + " check(s) failed.", op::Priority::High);
+        return -1;
+    }
+    op::log("Float to half test successfully finished.", op::Priority::High);
+    return 0;
+}
+
+int main()
+{
+    return floatToHalfTest();
+}
@@ -0,0 +1,143 @@
+// ------------------------- OpenPose Library Tests - Frame Buffer Pool -------------------------
+// Regression test of dllExport::FrameBufferPool (tutorial_pose/dllExport/frameBufferPool.hpp), the cv::MatAllocator of
+// the per-frame cv::Mat of the DLL:
+    // 1. A released buffer is served again (a hit) to the next cv::Mat of its size class, also for a slightly
+    //    different frame size, while a different size class is a miss
+    // 2. A copy of a pooled cv::Mat keeps its buffer in use until the last copy is released
+    // 3. Wrapped external memory is not pooled
+    // 4. clear() frees every idle buffer
+// The pool is a singleton, so every check is made on the difference of its counters. It returns 0 if every check
+// passes.
+
+// C++ std library dependencies
+#include <string>
+#include <vector>
+// OpenPose dependencies
+#include <opencv2/core/core.hpp>
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "../tutorial_pose/dllExport/frameBufferPool.hpp"
+
+namespace
+{
+    int numberFailures = 0;
+
+    void expect(const bool condition, const std::string& message)
+    {
+        if (!condition)
+        {
+            numberFailures++;
+            op::log("FAILED: " + message, op::Priority::High);
+        }
+    }
+
+    cv::Mat getPooledMat(const int rows, const int cols)
+    {
+        cv::Mat cvMat;
+        cvMat.allocator = &dllExport::FrameBufferPool::getInstance();
+        cvMat.create(rows, cols, CV_8UC3);
+        return cvMat;
+    }
+
+    void testReuse()
+    {
+        auto& frameBufferPool = dllExport::FrameBufferPool::getInstance();
+        frameBufferPool.clear();
+        const auto numberHits = frameBufferPool.getNumberHits();
+        const auto numberMisses = frameBufferPool.getNumberMisses();
+        auto cvMat = getPooledMat(480, 640);
+        const auto* const data = cvMat.data;
+        expect(frameBufferPool.getNumberMisses() == numberMisses + 1, "the first buffer must be a miss");
+        cvMat.release();
+        const auto numberIdleBytes = frameBufferPool.getNumberIdleBytes();
+        expect(numberIdleBytes >= 480ull * 640ull * 3ull, "a released buffer must be kept idle");
+
+        // Same size: same buffer
+        cvMat = getPooledMat(480, 640);
+        expect(frameBufferPool.getNumberHits() == numberHits + 1 && cvMat.data == data,
+               "a buffer of the same size must be served from the pool");
+        expect(frameBufferPool.getNumberIdleBytes() == 0ull, "a served buffer must not be idle");
+        cvMat.release();
+        // Slightly smaller frame of the same size class: same buffer
+        cvMat = getPooledMat(478, 640);
+        expect(frameBufferPool.getNumberHits() == numberHits + 2 && cvMat.data == data,
+               "a buffer of the same size class must be served from the pool");
+        cvMat.release();
+        // Different size class: new buffer, the idle one is kept
+        cvMat = getPooledMat(1080, 1920);
+        expect(frameBufferPool.getNumberMisses() == numberMisses + 2 && cvMat.data != data
+               && frameBufferPool.getNumberIdleBytes() == numberIdleBytes,
+               "a buffer of another size class must be a miss");
+        cvMat.release();
+    }
+
+    void testCopies()
+    {
+        auto& frameBufferPool = dllExport::FrameBufferPool::getInstance();
+        frameBufferPool.clear();
+        auto cvMat = getPooledMat(480, 640);
+        auto cvMatCopy = cvMat;
+        cvMat.release();
+        expect(frameBufferPool.getNumberIdleBytes() == 0ull, "a buffer still referenced must not be idle");
+        cvMatCopy.release();
+        expect(frameBufferPool.getNumberIdleBytes() > 0ull, "the last release must return the buffer");
+    }
+
+    void testExternalMemory()
+    {
+        auto& frameBufferPool = dllExport::FrameBufferPool::getInstance();
+        frameBufferPool.clear();
+        const auto numberHits = frameBufferPool.getNumberHits();
+        const auto numberMisses = frameBufferPool.getNumberMisses();
+        std::vector<unsigned char> externalData(3 * 64 * 48);
+        const int sizes[2]{48, 64};
+        size_t steps[2];
+        auto* const uMatData = frameBufferPool.allocate(2, sizes, CV_8UC3, externalData.data(), steps,
+                                                        dllExport::FrameBufferPool::AccessFlags{},
+                                                        cv::USAGE_DEFAULT);
+        expect(uMatData != nullptr && uMatData->data == externalData.data()
+               && uMatData->currAllocator != &frameBufferPool,
+               "external memory must be wrapped by the default allocator");
+        if (uMatData != nullptr)
+            uMatData->currAllocator->deallocate(uMatData);
+        expect(frameBufferPool.getNumberHits() == numberHits && frameBufferPool.getNumberMisses() == numberMisses
+               && frameBufferPool.getNumberIdleBytes() == 0ull, "external memory must not be pooled");
+    }
+
+    void testClear()
+    {
+        auto& frameBufferPool = dllExport::FrameBufferPool::getInstance();
+        {
+            auto cvMat0 = getPooledMat(480, 640);
+            auto cvMat1 = getPooledMat(240, 320);
+        }
+        expect(frameBufferPool.getNumberIdleBytes() > 0ull, "released buffers must be idle");
+        frameBufferPool.clear();
+        expect(frameBufferPool.getNumberIdleBytes() == 0ull, "clear() must free every idle buffer");
+        const auto numberMisses = frameBufferPool.getNumberMisses();
+        getPooledMat(480, 640);
+        expect(frameBufferPool.getNumberMisses() == numberMisses + 1, "a buffer after clear() must be a miss");
+        frameBufferPool.clear();
+    }
+}
+
+int frameBufferPoolTest()
+{
+    op::log("OpenPose Library Tests - Frame Buffer Pool.", op::Priority::High);
+    testReuse();
+    testCopies();
+    testExternalMemory();
+    testClear();
+    if (numberFailures > 0)
+    {
+        op::log(std::to_string(numberFailures) + " check(s) failed.", op::Priority::High);
+        return -1;
+    }
+    op::log("Frame buffer pool test successfully finished.", op::Priority::High);
+    return 0;
+}
+
+int main()
+{
+    return frameBufferPoolTest();
+}
@@ -0,0 +1,192 @@
+// ------------------------- OpenPose Library Tests - Fused cv::Mat To op Input -------------------------
+// Regression test of dllExport::FusedCvMatToOpInput (tutorial_pose/dllExport/fusedCvMatToOpInput.hpp), the fused
+// resize, normalization and BGR deinterleaving of the net input. Random 8-bit BGR images are compared against a naive
+// reference, one output element at a time: output (x, y) samples the input bilinearly at (x / scale, y / scale)
+// (clamped to the last row and column), normalized as value / 256 - 0.5, and every element outside the resized input
+// is the padding -0.5.
+    // 1. Single scale: downscaling, identity and upscaling, with odd sizes so the SIMD loops (SSE2 or AVX2 vertical
+    //    blend, AVX2 gathers) also run their remainders
+    // 2. The overload writing into an existing op::Array: its memory is re-used when the size is kept
+    // 3. Multi-scale: each scale is its cv::INTER_AREA pyramid level, also when a scale is bigger than the previous one
+// It returns 0 if every check passes.
+
+// C++ std library dependencies
+#include <algorithm> // std::min
+#include <cmath> // std::abs, std::ceil, std::floor
+#include <random>
+#include <string>
+#include <vector>
+// OpenPose dependencies
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp> // cv::resize
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "../tutorial_pose/dllExport/fusedCvMatToOpInput.hpp"
+
+namespace
+{
+    int numberFailures = 0;
+
+    void expect(const bool condition, const std::string& message)
+    {
+        if (!condition)
+        {
+            numberFailures++;
+            op::log("FAILED: " + message, op::Priority::High);
+        }
+    }
+
+    cv::Mat getRandomImage(const int rows, const int cols, std::mt19937& randomEngine)
+    {
+        std::uniform_int_distribution<int> distribution{0, 255};
+        cv::Mat cvMat(rows, cols, CV_8UC3);
+        for (auto y = 0 ; y < rows ; y++)
+        {
+            auto* const row = cvMat.ptr<unsigned char>(y);
+            for (auto x = 0 ; x < 3 * cols ; x++)
+                row[x] = (unsigned char)distribution(randomEngine);
+        }
+        return cvMat;
+    }
+
+    // 3 x height x width planes of `source` resized by `scale`
+    std::vector<double> resizeNormalizeReference(const cv::Mat& source, const double scale, const int width,
+                                                 const int height)
+    {
+        std::vector<double> target(3 * width * height, -0.5);
+        const auto resizedWidth = std::min(width, (int)std::ceil(source.cols * scale));
+        const auto resizedHeight = std::min(height, (int)std::ceil(source.rows * scale));
+        for (auto y = 0 ; y < resizedHeight ; y++)
+        {
+            const auto sourceY = std::min(y / scale, source.rows - 1.);
+            const auto y0 = (int)std::floor(sourceY);
+            const auto y1 = std::min(y0 + 1, source.rows - 1);
+            const auto weightY = sourceY - y0;
+            for (auto x = 0 ; x < resizedWidth ; x++)
+            {
+                const auto sourceX = std::min(x / scale, source.cols - 1.);
+                const auto x0 = (int)std::floor(sourceX);
+                const auto x1 = std::min(x0 + 1, source.cols - 1);
+                const auto weightX = sourceX - x0;
+                for (auto c = 0 ; c < 3 ; c++)
+                {
+                    const auto top = (1. - weightX) * source.ptr<unsigned char>(y0)[3*x0+c]
+                                   + weightX * source.ptr<unsigned char>(y0)[3*x1+c];
+                    const auto bottom = (1. - weightX) * source.ptr<unsigned char>(y1)[3*x0+c]
+                                      + weightX * source.ptr<unsigned char>(y1)[3*x1+c];
+                    target[(c * height + y) * width + x] = ((1. - weightY) * top + weightY * bottom) / 256. - 0.5;
+                }
+            }
+        }
+        return target;
+    }
+
+    // Whether scale `scaleIndex` of `inputNetData` matches `reference`
+    bool isConverted(const op::Array<float>& inputNetData, const int scaleIndex, const std::vector<double>& reference)
+    {
+        const auto scaleVolume = (int)reference.size();
+        if ((int)inputNetData.getVolume() < (scaleIndex + 1) * scaleVolume)
+            return false;
+        const auto* const scalePtr = inputNetData.getConstPtr() + scaleIndex * scaleVolume;
+        for (auto i = 0 ; i < scaleVolume ; i++)
+            if (std::abs(scalePtr[i] - reference[i]) > 1e-5)
+                return false;
+        return true;
+    }
+
+    void testSingleScale()
+    {
+        std::mt19937 randomEngine{2017u};
+        dllExport::FusedCvMatToOpInput fusedCvMatToOpInput;
+        struct TestCase { int rows; int cols; double scale; int width; int height; };
+        // Padded on both sides, exact fit, upscaled past the target, and the 1-pixel-wide remainders
+        for (const auto& testCase : {TestCase{37, 53, 0.61, 40, 24}, TestCase{37, 53, 1., 64, 48},
+                                     TestCase{37, 53, 1., 53, 37}, TestCase{37, 53, 1.7, 57, 61},
+                                     TestCase{1, 1, 3., 9, 3}, TestCase{120, 161, 0.5, 81, 57}})
+        {
+            const auto image = getRandomImage(testCase.rows, testCase.cols, randomEngine);
+            const auto inputNetData = fusedCvMatToOpInput.createArray(
+                image, {testCase.scale}, {op::Point<int>{testCase.width, testCase.height}});
+            const auto name = std::to_string(testCase.cols) + "x" + std::to_string(testCase.rows) + " image, scale "
+                            + std::to_string(testCase.scale) + ", net input " + std::to_string(testCase.width) + "x"
+                            + std::to_string(testCase.height);
+            expect(inputNetData.getSize() == std::vector<int>{1, 3, testCase.height, testCase.width},
+                   "wrong net input size for the " + name);
+            expect(isConverted(inputNetData, 0, resizeNormalizeReference(image, testCase.scale, testCase.width,
+                                                                         testCase.height)),
+                   "wrong net input for the " + name);
+        }
+    }
+
+    void testArrayReuse()
+    {
+        std::mt19937 randomEngine{2018u};
+        dllExport::FusedCvMatToOpInput fusedCvMatToOpInput;
+        op::Array<float> inputNetData;
+        const std::vector<op::Point<int>> netInputSizes{op::Point<int>{41, 33}};
+        auto image = getRandomImage(60, 75, randomEngine);
+        fusedCvMatToOpInput.createArray(inputNetData, image, {0.5}, netInputSizes);
+        const auto* const inputNetPtr = inputNetData.getConstPtr();
+        expect(isConverted(inputNetData, 0, resizeNormalizeReference(image, 0.5, 41, 33)),
+               "wrong net input written into an empty op::Array");
+        // Same size: same memory, new content (the cached coefficient tables must still match)
+        image = getRandomImage(60, 75, randomEngine);
+        fusedCvMatToOpInput.createArray(inputNetData, image, {0.5}, netInputSizes);
+        expect(inputNetData.getConstPtr() == inputNetPtr, "an op::Array of the same size must be re-used");
+        expect(isConverted(inputNetData, 0, resizeNormalizeReference(image, 0.5, 41, 33)),
+               "wrong net input written into a re-used op::Array");
+        // New image size and scale: the coefficient tables must be rebuilt
+        image = getRandomImage(45, 50, randomEngine);
+        fusedCvMatToOpInput.createArray(inputNetData, image, {0.85}, netInputSizes);
+        expect(isConverted(inputNetData, 0, resizeNormalizeReference(image, 0.85, 41, 33)),
+               "wrong net input after a change of image size and scale");
+        // Only the scale changes (the resized size is still clamped to the net input size)
+        fusedCvMatToOpInput.createArray(inputNetData, image, {0.95}, netInputSizes);
+        expect(isConverted(inputNetData, 0, resizeNormalizeReference(image, 0.95, 41, 33)),
+               "wrong net input after a change of scale");
+    }
+
+    void testMultiScale()
+    {
+        std::mt19937 randomEngine{2019u};
+        dllExport::FusedCvMatToOpInput fusedCvMatToOpInput;
+        const auto image = getRandomImage(47, 65, randomEngine);
+        const op::Point<int> netInputSize{72, 48};
+        // The second scale is derived from the first level, the third one starts again from the input
+        const std::vector<double> scales{0.7, 0.45, 1.};
+        const auto inputNetData = fusedCvMatToOpInput.createArray(
+            image, scales, std::vector<op::Point<int>>(scales.size(), netInputSize));
+        expect(inputNetData.getSize() == std::vector<int>{3, 3, netInputSize.y, netInputSize.x},
+               "wrong multi-scale net input size");
+        std::vector<cv::Mat> levels(scales.size());
+        cv::resize(image, levels[0], cv::Size{(int)std::ceil(65 * 0.7), (int)std::ceil(47 * 0.7)}, 0, 0,
+                   cv::INTER_AREA);
+        cv::resize(levels[0], levels[1], cv::Size{(int)std::ceil(65 * 0.45), (int)std::ceil(47 * 0.45)}, 0, 0,
+                   cv::INTER_AREA);
+        levels[2] = image;
+        for (auto i = 0u ; i < scales.size() ; i++)
+            expect(isConverted(inputNetData, (int)i, resizeNormalizeReference(levels[i], 1., netInputSize.x,
+                                                                              netInputSize.y)),
+                   "wrong net input of scale " + std::to_string(scales[i]));
+    }
+}
+
+int fusedCvMatToOpInputTest()
+{
+    op::log("OpenPose Library Tests - Fused cv::Mat To op Input.", op::Priority::High);
+    testSingleScale();
+    testArrayReuse();
+    testMultiScale();
+    if (numberFailures > 0)
+    {
+        op::log(std::to_string(numberFailures) + " check(s) failed.", op::Priority::High);
+        return -1;
+    }
+    op::log("Fused cv::Mat to op input test successfully finished.", op::Priority::High);
+    return 0;
+}
+
+int main()
+{
+    return fusedCvMatToOpInputTest();
+}
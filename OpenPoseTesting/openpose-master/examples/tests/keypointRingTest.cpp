@@ -0,0 +1,183 @@
+// ------------------------- OpenPose Library Tests - Keypoint Ring -------------------------
+// Regression test of dllExport::KeypointRing (tutorial_pose/dllExport/keypointRing.hpp), the lock-free ring between
+// the output worker and openPoseSessionPollKeypoints:
+    // 1. Single thread: empty ring, latest entry, `minimumFrameId`, rows of the arrays with fewer people, null
+    //    arrays and caller buffers smaller than the ring ones
+    // 2. Torn reads: a producer thread keeps overwriting a 2-slot ring (so the consumer often reads the slot being
+    //    rewritten) while the consumer polls. Every keypoint of entry i is i, so a poll that mixed 2 entries would
+    //    return values different from its frameId. It must never happen, whatever the retries.
+// It returns 0 if every check passes.
+
+// C++ std library dependencies
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "../tutorial_pose/dllExport/keypointRing.hpp"
+
+namespace
+{
+    int numberFailures = 0;
+
+    void expect(const bool condition, const std::string& message)
+    {
+        if (!condition)
+        {
+            numberFailures++;
+            op::log("FAILED: " + message, op::Priority::High);
+        }
+    }
+
+    const auto NUMBER_BODY_PARTS = 18;
+    const auto NUMBER_FACE_PARTS = 70;
+    const auto NUMBER_HAND_PARTS = 21;
+    const auto MAX_PEOPLE = 4;
+
+    // Datum whose keypoints (coordinates and scores) are all `value`
+    op::Datum getDatum(const unsigned long long id, const int numberPeople, const float value, const bool withFace)
+    {
+        op::Datum datum;
+        datum.id = id;
+        datum.poseKeypoints = op::Array<float>{{numberPeople, NUMBER_BODY_PARTS, 3}, value};
+        if (withFace)
+            datum.faceKeypoints = op::Array<float>{{numberPeople, NUMBER_FACE_PARTS, 3}, value};
+        return datum;
+    }
+
+    OpenPoseKeypointFrame getFrame(std::vector<float>& poseKeypoints, std::vector<float>& faceKeypoints,
+                                   std::vector<float>& handKeypoints, const int maxPeople)
+    {
+        poseKeypoints.assign(maxPeople * NUMBER_BODY_PARTS * 3, -1.f);
+        faceKeypoints.assign(maxPeople * NUMBER_FACE_PARTS * 3, -1.f);
+        handKeypoints.assign(2 * maxPeople * NUMBER_HAND_PARTS * 3, -1.f);
+        OpenPoseKeypointFrame frame{};
+        frame.poseKeypoints = poseKeypoints.data();
+        frame.faceKeypoints = faceKeypoints.data();
+        frame.handKeypoints = handKeypoints.data();
+        frame.maxPeople = maxPeople;
+        return frame;
+    }
+
+    bool allEqual(const float* const values, const int size, const float value)
+    {
+        for (auto i = 0 ; i < size ; i++)
+            if (values[i] != value)
+                return false;
+        return true;
+    }
+
+    void testSingleThread()
+    {
+        dllExport::KeypointRing keypointRing{NUMBER_BODY_PARTS, NUMBER_FACE_PARTS, NUMBER_HAND_PARTS, MAX_PEOPLE, 3u};
+        std::vector<float> poseKeypoints, faceKeypoints, handKeypoints;
+        auto frame = getFrame(poseKeypoints, faceKeypoints, handKeypoints, MAX_PEOPLE);
+        expect(!keypointRing.pollLatest(frame), "an empty ring must not return an entry");
+        expect(frame.poseKeypoints[0] == -1.f, "an empty ring must not touch the caller buffers");
+
+        // Latest of several entries, more than the capacity
+        for (auto id = 1ull ; id <= 5ull ; id++)
+            keypointRing.push(getDatum(id, 3, float(id), true));
+        expect(keypointRing.pollLatest(frame), "the latest entry must be returned");
+        expect(frame.frameId == 5ull && frame.numberPeople == 3 && frame.numberBodyParts == NUMBER_BODY_PARTS
+               && frame.numberFaceParts == NUMBER_FACE_PARTS && frame.numberHandParts == 0,
+               "wrong header of the latest entry");
+        expect(allEqual(frame.poseKeypoints, 3 * NUMBER_BODY_PARTS * 3, 5.f)
+               && allEqual(frame.faceKeypoints, 3 * NUMBER_FACE_PARTS * 3, 5.f),
+               "wrong keypoints of the latest entry");
+        expect(frame.poseKeypoints[3 * NUMBER_BODY_PARTS * 3] == -1.f, "rows after numberPeople must not be written");
+
+        // Entries older than minimumFrameId are not returned
+        frame = getFrame(poseKeypoints, faceKeypoints, handKeypoints, MAX_PEOPLE);
+        expect(!keypointRing.pollLatest(frame, 6ull) && frame.poseKeypoints[0] == -1.f,
+               "entries older than minimumFrameId must not be returned");
+
+        // Fewer face than body people: the face rows of the slot (written by older entries) are zeroed
+        auto datum = getDatum(6ull, 3, 6.f, true);
+        datum.faceKeypoints = op::Array<float>{{1, NUMBER_FACE_PARTS, 3}, 6.f};
+        // Slot 6 % 3 = 0 was last written by entry 3, with 3 face people
+        keypointRing.push(datum);
+        expect(keypointRing.pollLatest(frame, 6ull), "the entry of minimumFrameId must be returned");
+        expect(allEqual(frame.faceKeypoints, NUMBER_FACE_PARTS * 3, 6.f)
+               && allEqual(frame.faceKeypoints + NUMBER_FACE_PARTS * 3, 2 * NUMBER_FACE_PARTS * 3, 0.f),
+               "face rows after the face people must be zero");
+
+        // Null arrays are skipped and the people are limited to the caller maxPeople
+        std::vector<float> smallPoseKeypoints, smallFaceKeypoints, smallHandKeypoints;
+        auto smallFrame = getFrame(smallPoseKeypoints, smallFaceKeypoints, smallHandKeypoints, 2);
+        smallFrame.faceKeypoints = nullptr;
+        smallFrame.handKeypoints = nullptr;
+        expect(keypointRing.pollLatest(smallFrame), "a frame with null arrays must still be filled");
+        expect(smallFrame.numberPeople == 2 && allEqual(smallFrame.poseKeypoints, 2 * NUMBER_BODY_PARTS * 3, 6.f),
+               "the people must be limited to the caller maxPeople");
+    }
+
+    void testTornReads()
+    {
+        const auto numberEntries = 1000000ull;
+        // 2 slots: the producer rewrites the slot read by the consumer every other entry
+        dllExport::KeypointRing keypointRing{NUMBER_BODY_PARTS, NUMBER_FACE_PARTS, NUMBER_HAND_PARTS, MAX_PEOPLE, 2u};
+        // Preallocated datums, so the producer only rewrites their values
+        std::vector<op::Datum> datums;
+        for (auto numberPeople = 1 ; numberPeople <= MAX_PEOPLE ; numberPeople++)
+            datums.emplace_back(getDatum(0ull, numberPeople, 0.f, true));
+        std::atomic<bool> isProducerDone{false};
+        std::thread producerThread{[&]
+        {
+            for (auto id = 1ull ; id <= numberEntries ; id++)
+            {
+                // The number of people also changes from entry to entry
+                auto& datum = datums[id % MAX_PEOPLE];
+                datum.id = id;
+                for (auto* array : {&datum.poseKeypoints, &datum.faceKeypoints})
+                    for (auto i = 0u ; i < array->getVolume() ; i++)
+                        array->getPtr()[i] = float(id);
+                keypointRing.push(datum);
+            }
+            isProducerDone = true;
+        }};
+        std::vector<float> poseKeypoints, faceKeypoints, handKeypoints;
+        auto frame = getFrame(poseKeypoints, faceKeypoints, handKeypoints, MAX_PEOPLE);
+        auto numberPolls = 0ull;
+        auto numberTornReads = 0ull;
+        auto lastFrameId = 0ull;
+        while (!isProducerDone || frame.frameId != numberEntries)
+        {
+            if (!keypointRing.pollLatest(frame))
+                continue;
+            numberPolls++;
+            const auto value = float(frame.frameId);
+            const auto numberPeople = (int)(frame.frameId % MAX_PEOPLE) + 1;
+            if (frame.numberPeople != numberPeople || frame.frameId < lastFrameId
+                || !allEqual(frame.poseKeypoints, numberPeople * NUMBER_BODY_PARTS * 3, value)
+                || !allEqual(frame.faceKeypoints, numberPeople * NUMBER_FACE_PARTS * 3, value))
+                numberTornReads++;
+            lastFrameId = frame.frameId;
+        }
+        producerThread.join();
+        expect(numberTornReads == 0ull, std::to_string(numberTornReads) + " of " + std::to_string(numberPolls)
+               + " polls returned a torn or out of order entry");
+        op::log("Torn reads: " + std::to_string(numberPolls) + " polls checked.", op::Priority::High);
+    }
+}
+
+int keypointRingTest()
+{
+    op::log("OpenPose Library Tests - Keypoint Ring.", op::Priority::High);
+    testSingleThread();
+    testTornReads();
+    if (numberFailures > 0)
+    {
+        op::log(std::to_string(numberFailures) + " check(s) failed.", op::Priority::High);
+        return -1;
+    }
+    op::log("Keypoint ring test successfully finished.", op::Priority::High);
+    return 0;
+}
+
+int main()
+{
+    return keypointRingTest();
+}
@@ -0,0 +1,146 @@
+// ------------------------- OpenPose Library Tests - Keypoint Scaling -------------------------
+// Regression test of dllExport::KeypointScaling (tutorial_pose/dllExport/keypointScaling.hpp), the vectorized
+// replacement of op::KeypointScaler:
+    // 1. transformKeypoints (SSE2 or AVX blocks) against a scalar reference, for every number of keypoints up to a few
+    //    blocks (so every block remainder is covered), out of place and in place. The scores must be copied exactly
+    // 2. getKeypointScaleTransform: the input resolution corners go to the ends of the ZeroToOne and PlusMinusOne
+    //    ranges, and the output and input resolutions are each other's inverse
+    // 3. KeypointScaling::scale transforms the pose, face and both hand arrays of a Datum
+// It returns 0 if every check passes.
+
+// C++ std library dependencies
+#include <cmath> // std::abs
+#include <random>
+#include <string>
+#include <vector>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "../tutorial_pose/dllExport/keypointScaling.hpp"
+
+namespace
+{
+    int numberFailures = 0;
+
+    void expect(const bool condition, const std::string& message)
+    {
+        if (!condition)
+        {
+            numberFailures++;
+            op::log("FAILED: " + message, op::Priority::High);
+        }
+    }
+
+    bool isClose(const float value, const double reference)
+    {
+        return std::abs(value - reference) <= 1e-5 * (1. + std::abs(reference));
+    }
+
+    // Whether `target` is `source` transformed, with the scores untouched
+    bool isTransformed(const float* const target, const float* const source, const int numberKeypoints,
+                       const dllExport::KeypointTransform& transform)
+    {
+        for (auto i = 0 ; i < numberKeypoints ; i++)
+            if (!isClose(target[3*i], (double)source[3*i] * transform.scaleX + transform.offsetX)
+                || !isClose(target[3*i+1], (double)source[3*i+1] * transform.scaleY + transform.offsetY)
+                || target[3*i+2] != source[3*i+2])
+                return false;
+        return true;
+    }
+
+    void testTransformKeypoints()
+    {
+        std::mt19937 randomEngine{2017u};
+        std::uniform_real_distribution<float> distribution{0.f, 1920.f};
+        const dllExport::KeypointTransform transform{0.37f, 1.9f, -3.f, 11.f};
+        for (auto numberKeypoints = 0 ; numberKeypoints <= 40 ; numberKeypoints++)
+        {
+            std::vector<float> source(3 * numberKeypoints);
+            for (auto& value : source)
+                value = distribution(randomEngine);
+            // The extra element must never be written
+            std::vector<float> target(3 * numberKeypoints + 1, -7.f);
+            dllExport::transformKeypoints(target.data(), source.data(), numberKeypoints, transform);
+            expect(isTransformed(target.data(), source.data(), numberKeypoints, transform) && target.back() == -7.f,
+                   "transformKeypoints of " + std::to_string(numberKeypoints) + " keypoints");
+            auto inPlace = source;
+            dllExport::transformKeypoints(inPlace.data(), inPlace.data(), numberKeypoints, transform);
+            expect(isTransformed(inPlace.data(), source.data(), numberKeypoints, transform),
+                   "in-place transformKeypoints of " + std::to_string(numberKeypoints) + " keypoints");
+        }
+    }
+
+    void testKeypointScaleTransform()
+    {
+        const op::Point<int> inputSize{1280, 720};
+        const auto scaleInputToOutput = 0.5;
+        const auto scaleNetToOutput = 4.;
+        // Input resolution corners -> ends of the normalized ranges
+        const auto zeroToOne = dllExport::getKeypointScaleTransform(op::ScaleMode::ZeroToOne, scaleInputToOutput,
+                                                                    scaleNetToOutput, inputSize, true);
+        expect(isClose(zeroToOne.offsetX, 0.) && isClose(1279.f * zeroToOne.scaleX + zeroToOne.offsetX, 1.)
+               && isClose(719.f * zeroToOne.scaleY + zeroToOne.offsetY, 1.), "ZeroToOne transform");
+        const auto plusMinusOne = dllExport::getKeypointScaleTransform(
+            op::ScaleMode::PlusMinusOne, scaleInputToOutput, scaleNetToOutput, inputSize, true);
+        expect(isClose(plusMinusOne.offsetX, -1.) && isClose(1279.f * plusMinusOne.scaleX + plusMinusOne.offsetX, 1.)
+               && isClose(719.f * plusMinusOne.scaleY + plusMinusOne.offsetY, 1.), "PlusMinusOne transform");
+        // Output resolution <-> input resolution
+        const auto toOutput = dllExport::getKeypointScaleTransform(op::ScaleMode::OutputResolution, scaleInputToOutput,
+                                                                   scaleNetToOutput, inputSize, true);
+        const auto toInput = dllExport::getKeypointScaleTransform(op::ScaleMode::InputResolution, scaleInputToOutput,
+                                                                  scaleNetToOutput, inputSize, false);
+        expect(isClose(toOutput.scaleX, scaleInputToOutput) && isClose(toInput.scaleX, 1. / scaleInputToOutput)
+               && isClose(toOutput.scaleX * toInput.scaleX, 1.) && toOutput.offsetX == 0.f && toInput.offsetX == 0.f,
+               "OutputResolution and InputResolution transforms");
+        // Input resolution -> net output resolution
+        const auto toNetOutput = dllExport::getKeypointScaleTransform(
+            op::ScaleMode::NetOutputResolution, scaleInputToOutput, scaleNetToOutput, inputSize, true);
+        expect(isClose(toNetOutput.scaleX, 1. / scaleNetToOutput) && isClose(toNetOutput.scaleY, 1. / scaleNetToOutput),
+               "NetOutputResolution transform");
+    }
+
+    void testKeypointScaling()
+    {
+        op::Datum datum;
+        datum.scaleInputToOutput = 0.5;
+        datum.scaleNetToOutput = 4.;
+        datum.poseKeypoints = op::Array<float>{{2, 18, 3}, 100.f};
+        datum.faceKeypoints = op::Array<float>{{2, 70, 3}, 100.f};
+        datum.handKeypoints[0] = op::Array<float>{{2, 21, 3}, 100.f};
+        datum.handKeypoints[1] = op::Array<float>{{2, 21, 3}, 100.f};
+        const op::Point<int> inputSize{201, 101};
+        // Identity: untouched
+        dllExport::KeypointScaling{op::ScaleMode::InputResolution}.scale(datum, inputSize);
+        expect(datum.poseKeypoints[0] == 100.f, "InputResolution must leave the keypoints untouched");
+        // ZeroToOne: x = 100 / 200, y = 100 / 100, scores kept
+        dllExport::KeypointScaling{op::ScaleMode::ZeroToOne}.scale(datum, inputSize);
+        for (const auto* array : {&datum.poseKeypoints, &datum.faceKeypoints, &datum.handKeypoints[0],
+                                  &datum.handKeypoints[1]})
+        {
+            auto isScaled = true;
+            for (auto i = 0u ; i < array->getVolume() ; i += 3)
+                isScaled &= (isClose((*array)[i], 0.5) && isClose((*array)[i+1], 1.) && (*array)[i+2] == 100.f);
+            expect(isScaled, "KeypointScaling::scale with ZeroToOne");
+        }
+    }
+}
+
+int keypointScalingTest()
+{
+    op::log("OpenPose Library Tests - Keypoint Scaling.", op::Priority::High);
+    testTransformKeypoints();
+    testKeypointScaleTransform();
+    testKeypointScaling();
+    if (numberFailures > 0)
+    {
+        op::log(std::to_string(numberFailures) + " check(s) failed.", op::Priority::High);
+        return -1;
+    }
+    op::log("Keypoint scaling test successfully finished.", op::Priority::High);
+    return 0;
+}
+
+int main()
+{
+    return keypointScalingTest();
+}
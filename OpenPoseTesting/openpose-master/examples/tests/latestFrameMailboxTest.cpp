@@ -0,0 +1,126 @@
+// ------------------------- OpenPose Library Tests - Latest Frame Mailbox -------------------------
+// Regression test of dllExport::LatestFrameMailbox (tutorial_pose/dllExport/wLatestFrameInput.hpp), the single-slot
+// mailbox between openPoseSessionPushFrame and the input worker:
+    // 1. Single thread: take() timeout, put() reporting the overwritten frame, take() returning the newest one
+    // 2. Concurrent put() and take(): frames are taken in order, and every frame is either taken or dropped exactly
+    //    once, i.e. released (the host frame buffer lease) exactly once
+// It returns 0 if every check passes.
+
+// C++ std library dependencies
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "../tutorial_pose/dllExport/wLatestFrameInput.hpp"
+
+namespace
+{
+    int numberFailures = 0;
+
+    void expect(const bool condition, const std::string& message)
+    {
+        if (!condition)
+        {
+            numberFailures++;
+            op::log("FAILED: " + message, op::Priority::High);
+        }
+    }
+
+    typedef std::shared_ptr<unsigned long long> FramePtr;
+
+    // Frame whose release (as the host frame lease of a session) increments `numberReleased`
+    FramePtr getFrame(const unsigned long long frameId, std::atomic<unsigned long long>& numberReleased)
+    {
+        return FramePtr{new unsigned long long{frameId}, [&numberReleased](unsigned long long* frameIdPtr)
+        {
+            numberReleased++;
+            delete frameIdPtr;
+        }};
+    }
+
+    void testSingleThread()
+    {
+        dllExport::LatestFrameMailbox<FramePtr> latestFrameMailbox;
+        std::atomic<unsigned long long> numberReleased{0ull};
+        const auto beginTime = std::chrono::steady_clock::now();
+        expect(latestFrameMailbox.take(std::chrono::milliseconds{20}) == nullptr,
+               "take() on an empty mailbox must return nullptr");
+        expect(std::chrono::steady_clock::now() - beginTime >= std::chrono::milliseconds{20},
+               "take() on an empty mailbox must wait for the timeout");
+        expect(!latestFrameMailbox.put(getFrame(1ull, numberReleased)),
+               "put() into an empty mailbox must not overwrite");
+        expect(latestFrameMailbox.put(getFrame(2ull, numberReleased)), "put() into a full mailbox must overwrite");
+        expect(numberReleased == 1ull, "the overwritten frame must be released by put()");
+        const auto frame = latestFrameMailbox.take(std::chrono::milliseconds{0});
+        expect(frame != nullptr && *frame == 2ull, "take() must return the newest frame");
+        expect(latestFrameMailbox.take(std::chrono::milliseconds{0}) == nullptr, "take() must empty the mailbox");
+    }
+
+    void testConcurrentPutAndTake()
+    {
+        const auto numberFrames = 200000ull;
+        std::atomic<unsigned long long> numberReleased{0ull};
+        auto numberTaken = 0ull;
+        auto numberOverwritten = 0ull;
+        auto numberOutOfOrder = 0ull;
+        {
+            dllExport::LatestFrameMailbox<FramePtr> latestFrameMailbox;
+            std::atomic<bool> isProducerDone{false};
+            std::thread producerThread{[&]
+            {
+                for (auto frameId = 1ull ; frameId <= numberFrames ; frameId++)
+                    if (latestFrameMailbox.put(getFrame(frameId, numberReleased)))
+                        numberOverwritten++;
+                isProducerDone = true;
+            }};
+            auto lastFrameId = 0ull;
+            while (true)
+            {
+                const auto wasProducerDone = isProducerDone.load();
+                const auto frame = latestFrameMailbox.take(std::chrono::milliseconds{1});
+                if (frame != nullptr)
+                {
+                    numberTaken++;
+                    if (*frame <= lastFrameId)
+                        numberOutOfOrder++;
+                    lastFrameId = *frame;
+                }
+                // Nothing left once the producer had finished before this take()
+                else if (wasProducerDone)
+                    break;
+            }
+            producerThread.join();
+            expect(lastFrameId == numberFrames, "the last frame must always be taken");
+        }
+        expect(numberOutOfOrder == 0ull, std::to_string(numberOutOfOrder) + " frames taken out of order");
+        expect(numberTaken + numberOverwritten == numberFrames, std::to_string(numberTaken) + " frames taken and "
+               + std::to_string(numberOverwritten) + " overwritten, out of " + std::to_string(numberFrames));
+        expect(numberReleased == numberFrames, std::to_string(numberReleased) + " frames released, out of "
+               + std::to_string(numberFrames));
+        op::log("Concurrent put() and take(): " + std::to_string(numberTaken) + " frames taken and "
+                + std::to_string(numberOverwritten) + " dropped.", op::Priority::High);
+    }
+}
+
+int latestFrameMailboxTest()
+{
+    op::log("OpenPose Library Tests - Latest Frame Mailbox.", op::Priority::High);
+    testSingleThread();
+    testConcurrentPutAndTake();
+    if (numberFailures > 0)
+    {
+        op::log(std::to_string(numberFailures) + " check(s) failed.", op::Priority::High);
+        return -1;
+    }
+    op::log("Latest frame mailbox test successfully finished.", op::Priority::High);
+    return 0;
+}
+
+int main()
+{
+    return latestFrameMailboxTest();
+}
@@ -100,14 +100,22 @@ int openPoseTutorialPose2()
         poseModel, FLAGS_model_folder, FLAGS_num_gpu_start, std::vector<op::HeatMapType>{}, op::ScaleMode::ZeroToOne,
         enableGoogleLogging
     );
-    op::PoseGpuRenderer poseGpuRenderer{poseModel, poseExtractorPtr, (float)FLAGS_render_threshold,
-                                        !FLAGS_disable_blending, (float)FLAGS_alpha_pose, (float)FLAGS_alpha_heatmap};
-    poseGpuRenderer.setElementToRender(FLAGS_part_to_show);
+    #ifdef USE_CUDA
+        op::PoseGpuRenderer poseRenderer{poseModel, poseExtractorPtr, (float)FLAGS_render_threshold,
+                                         !FLAGS_disable_blending, (float)FLAGS_alpha_pose, (float)FLAGS_alpha_heatmap};
+        poseRenderer.setElementToRender(FLAGS_part_to_show);
+    #else
+        // CPU_ONLY builds have no GPU renderer, and the CPU one only renders the keypoints
+        if (FLAGS_part_to_show != 0)
+            op::log("Heatmaps can only be rendered on GPU, rendering the keypoints instead.", op::Priority::High);
+        op::PoseCpuRenderer poseRenderer{poseModel, (float)FLAGS_render_threshold, !FLAGS_disable_blending,
+                                         (float)FLAGS_alpha_pose};
+    #endif
     op::OpOutputToCvMat opOutputToCvMat;
     op::FrameDisplayer frameDisplayer{"OpenPose Tutorial - Example 2", outputSize};
     // Step 4 - Initialize resources on desired thread (in this case single thread, i.e. we init resources here)
     poseExtractorPtr->initializationOnThread();
-    poseGpuRenderer.initializationOnThread();
+    poseRenderer.initializationOnThread();
 
     // ------------------------- POSE ESTIMATION AND RENDERING -------------------------
     // Step 1 - Read and load image, error if empty (possibly wrong path)
@@ -131,7 +139,12 @@ int openPoseTutorialPose2()
     const auto poseKeypoints = poseExtractorPtr->getPoseKeypoints();
     const auto scaleNetToOutput = poseExtractorPtr->getScaleNetToOutput();
     // Step 5 - Render pose
-    poseGpuRenderer.renderPose(outputArray, poseKeypoints, scaleInputToOutput, scaleNetToOutput);
+    #ifdef USE_CUDA
+        poseRenderer.renderPose(outputArray, poseKeypoints, scaleInputToOutput, scaleNetToOutput);
+    #else
+        UNUSED(scaleNetToOutput);
+        poseRenderer.renderPose(outputArray, poseKeypoints, scaleInputToOutput);
+    #endif
     // Step 6 - OpenPose output format to cv::Mat
     auto outputImage = opOutputToCvMat.formatToCvMat(outputArray);
 
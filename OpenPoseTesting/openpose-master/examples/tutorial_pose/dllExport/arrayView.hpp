@@ -0,0 +1,229 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_ARRAY_VIEW_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_ARRAY_VIEW_HPP
+
+// C++ std library dependencies
+#include <algorithm> // std::fill, std::min
+#include <array>
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uintptr_t
+#include <initializer_list>
+#include <new> // ::operator new
+#include <utility> // std::swap
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+
+namespace dllExport
+{
+	// Alignment of AlignedBuffer: a cache line, which also covers SSE (16 bytes) and AVX (32 bytes) loads
+	const std::size_t BUFFER_ALIGNMENT = 64u;
+
+	/**
+	 * AlignedBuffer: growable scratch buffer whose data is aligned to BUFFER_ALIGNMENT bytes, so the SIMD kernels can
+	 * use aligned loads and stores from its first element.
+	 * Contrary to std::vector, growing it does not keep the previous content (the new memory is zero-filled), and it
+	 * never shrinks, so reusing it frame after frame does not allocate once the largest size has been seen.
+	 */
+	template<typename T>
+	class AlignedBuffer
+	{
+	public:
+		AlignedBuffer() :
+			pMemory{nullptr},
+			pData{nullptr},
+			mSize{0u},
+			mCapacity{0u}
+		{
+		}
+
+		explicit AlignedBuffer(const std::size_t size) :
+			AlignedBuffer{}
+		{
+			resize(size);
+		}
+
+		AlignedBuffer(AlignedBuffer&& alignedBuffer) noexcept :
+			pMemory{alignedBuffer.pMemory},
+			pData{alignedBuffer.pData},
+			mSize{alignedBuffer.mSize},
+			mCapacity{alignedBuffer.mCapacity}
+		{
+			alignedBuffer.pMemory = nullptr;
+			alignedBuffer.pData = nullptr;
+			alignedBuffer.mSize = 0u;
+			alignedBuffer.mCapacity = 0u;
+		}
+
+		AlignedBuffer& operator=(AlignedBuffer&& alignedBuffer) noexcept
+		{
+			std::swap(pMemory, alignedBuffer.pMemory);
+			std::swap(pData, alignedBuffer.pData);
+			std::swap(mSize, alignedBuffer.mSize);
+			std::swap(mCapacity, alignedBuffer.mCapacity);
+			return *this;
+		}
+
+		~AlignedBuffer()
+		{
+			::operator delete(pMemory);
+		}
+
+		void resize(const std::size_t size)
+		{
+			if (size > mCapacity)
+			{
+				auto* const memory = ::operator new(size * sizeof(T) + BUFFER_ALIGNMENT - 1u);
+				::operator delete(pMemory);
+				pMemory = memory;
+				pData = (T*)(((std::uintptr_t)memory + BUFFER_ALIGNMENT - 1u) & ~(std::uintptr_t)(BUFFER_ALIGNMENT - 1u));
+				std::fill(pData, pData + size, T{});
+				mCapacity = size;
+			}
+			mSize = size;
+		}
+
+		T* data()
+		{
+			return pData;
+		}
+
+		const T* data() const
+		{
+			return pData;
+		}
+
+		std::size_t size() const
+		{
+			return mSize;
+		}
+
+		T& operator[](const std::size_t index)
+		{
+			return pData[index];
+		}
+
+		const T& operator[](const std::size_t index) const
+		{
+			return pData[index];
+		}
+
+	private:
+		void* pMemory;
+		T* pData;
+		std::size_t mSize;
+		std::size_t mCapacity;
+
+		AlignedBuffer(const AlignedBuffer&) = delete;
+		AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+	};
+
+	/**
+	 * ArrayView: non-owning, N-dimensional (up to 4) view of contiguous row-major memory, e.g. of an op::Array.
+	 * slice() views a single element of the first dimension (a scale of the network input, a channel of a heatmap, a
+	 * person of a keypoint array...) without copying nor allocating. The viewed memory must outlive the view.
+	 * Use ArrayView<const T> for read-only memory.
+	 */
+	template<typename T>
+	class ArrayView
+	{
+	public:
+		ArrayView() :
+			pData{nullptr},
+			mNumberDimensions{0},
+			mSizes{{0, 0, 0, 0}}
+		{
+		}
+
+		ArrayView(T* const data, const std::initializer_list<int> sizes) :
+			ArrayView{}
+		{
+			pData = data;
+			for (const auto size : sizes)
+				if (mNumberDimensions < (int)mSizes.size())
+					mSizes[mNumberDimensions++] = size;
+		}
+
+		template<typename TArray>
+		explicit ArrayView(TArray& array) :
+			ArrayView{}
+		{
+			if (!array.empty())
+			{
+				pData = array.getPtr();
+				mNumberDimensions = std::min((int)array.getNumberDimensions(), (int)mSizes.size());
+				for (auto i = 0 ; i < mNumberDimensions ; i++)
+					mSizes[i] = array.getSize(i);
+			}
+		}
+
+		template<typename TArray>
+		explicit ArrayView(const TArray& array) :
+			ArrayView{}
+		{
+			if (!array.empty())
+			{
+				pData = array.getConstPtr();
+				mNumberDimensions = std::min((int)array.getNumberDimensions(), (int)mSizes.size());
+				for (auto i = 0 ; i < mNumberDimensions ; i++)
+					mSizes[i] = array.getSize(i);
+			}
+		}
+
+		bool empty() const
+		{
+			return pData == nullptr || getVolume() == 0;
+		}
+
+		T* getPtr() const
+		{
+			return pData;
+		}
+
+		int getNumberDimensions() const
+		{
+			return mNumberDimensions;
+		}
+
+		int getSize(const int index) const
+		{
+			return (index < mNumberDimensions ? mSizes[index] : 0);
+		}
+
+		int getVolume() const
+		{
+			if (mNumberDimensions == 0)
+				return 0;
+			auto volume = 1;
+			for (auto i = 0 ; i < mNumberDimensions ; i++)
+				volume *= mSizes[i];
+			return volume;
+		}
+
+		/**
+		 * View of element `index` of the first dimension, with the remaining dimensions.
+		 */
+		ArrayView slice(const int index) const
+		{
+			ArrayView arrayView;
+			if (mNumberDimensions > 0 && index >= 0 && index < mSizes[0])
+			{
+				arrayView.mNumberDimensions = mNumberDimensions - 1;
+				for (auto i = 1 ; i < mNumberDimensions ; i++)
+					arrayView.mSizes[i-1] = mSizes[i];
+				arrayView.pData = pData + index * (arrayView.mNumberDimensions > 0 ? arrayView.getVolume() : 1);
+			}
+			return arrayView;
+		}
+
+		T& operator[](const int index) const
+		{
+			return pData[index];
+		}
+
+	private:
+		T* pData;
+		int mNumberDimensions;
+		std::array<int, 4> mSizes;
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_ARRAY_VIEW_HPP
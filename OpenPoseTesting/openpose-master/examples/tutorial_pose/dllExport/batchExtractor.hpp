@@ -0,0 +1,337 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_BATCH_EXTRACTOR_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_BATCH_EXTRACTOR_HPP
+
+// C++ std library dependencies
+#include <algorithm> // std::min
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility> // std::pair
+#include <vector>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "../dllExportFile.hpp"
+#include "fusedCvMatToOpInput.hpp"
+#include "keypointScaling.hpp"
+#include "poseEngineCaffe.hpp"
+#include "poseEngineCaffeSharedWeights.hpp"
+#include "poseEngineOpenCv.hpp"
+#include "scalePlanCache.hpp"
+#include "stageStatistics.hpp"
+#include "timestamp.hpp"
+
+namespace dllExport
+{
+	/**
+	 * Everything required to build the body pose extraction chain of BatchExtractor (i.e. the relevant subset of
+	 * op::WrapperStructPose).
+	 */
+	struct BatchConfiguration
+	{
+		op::PoseModel poseModel;
+		std::string modelFolder;
+		int gpuNumberStart;
+		op::Point<int> netInputSize;
+		op::Point<int> outputSize;
+		int scalesNumber;
+		double scaleGap;
+		op::ScaleMode keypointScale;
+		OpenPosePoseEngine poseEngine;
+		std::string int8CalibrationPath;
+		// Caffe engine only: the weights are shared with the other BatchExtractor of the process with the same model and
+		// GPU (see PoseEngineCaffeSharedWeights)
+		bool shareWeights;
+	};
+
+	/**
+	 * BatchExtractor: body pose extraction of image lists with a single, always initialized, PoseEngine (see
+	 * BatchConfiguration::poseEngine). Caffe binds the network to the thread that initialized it, so the engine lives on
+	 * its own engine thread, which loads the network as soon as the BatchExtractor is created and then serves every
+	 * process() call. Meanwhile, the thread calling process() loads (decodes or converts) the images, at most
+	 * `maxLoadedImages` ahead of the forward pass, so the image loading overlaps the network.
+	 */
+	class BatchExtractor
+	{
+	public:
+		explicit BatchExtractor(const BatchConfiguration& batchConfiguration, const unsigned int maxLoadedImages = 2u) :
+			mNumberBodyParts{(int)op::POSE_NUMBER_BODY_PARTS.at((int)batchConfiguration.poseModel)},
+			mMaxLoadedImages{std::max(maxLoadedImages, 1u)},
+			mScalePlanCache{batchConfiguration.netInputSize, batchConfiguration.outputSize,
+				batchConfiguration.scalesNumber, batchConfiguration.scaleGap},
+			mKeypointScale{batchConfiguration.keypointScale},
+			upPoseEngine{createPoseEngine(batchConfiguration)},
+			mIsInitialized{false},
+			mIsStopped{false},
+			pFrames{nullptr},
+			mNumberProcessed{0},
+			mNumberSucceeded{0}
+		{
+			try
+			{
+				mEngineThread = std::thread{&BatchExtractor::engineLoop, this};
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+		~BatchExtractor()
+		{
+			try
+			{
+				{
+					const std::lock_guard<std::mutex> lock{mMutex};
+					mIsStopped = true;
+				}
+				mConditionVariable.notify_all();
+				if (mEngineThread.joinable())
+					mEngineThread.join();
+			}
+			catch (const std::exception& e)
+			{
+				op::log(e.what(), op::Priority::Max, __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+		/**
+		 * It extracts the body keypoints of `numberImages` images into `frames[0, numberImages)` (with the layout of
+		 * OpenPoseKeypointFrame, `frameId` being the image index). `imageLoader(i)` is called in order on the calling
+		 * thread and must return the i-th image as BGR cv::Mat, or an empty cv::Mat if it cannot be read. It blocks until
+		 * all images are processed (it waits for the network to be loaded first).
+		 * @return The number of images successfully processed. The images that could not be read or processed get
+		 * `numberPeople = -1` (and are not counted).
+		 */
+		int process(const int numberImages, const std::function<cv::Mat(const int)>& imageLoader,
+			OpenPoseKeypointFrame* const frames)
+		{
+			// Images handed to the engine thread, or -1 while pFrames is not set
+			auto numberPushed = -1;
+			try
+			{
+				const std::lock_guard<std::mutex> processLock{mProcessMutex};
+				{
+					std::unique_lock<std::mutex> lock{mMutex};
+					mConditionVariable.wait(lock, [this]{ return mIsInitialized; });
+					if (!mInitializationError.empty())
+						op::error("The pose network could not be loaded: " + mInitializationError,
+							__LINE__, __FUNCTION__, __FILE__);
+					pFrames = frames;
+					mNumberProcessed = 0;
+					mNumberSucceeded = 0;
+					numberPushed = 0;
+				}
+				for (auto i = 0 ; i < numberImages ; i++)
+				{
+					cv::Mat cvMat;
+					try
+					{
+						const auto loadBeginNs = getTimestampNs();
+						cvMat = imageLoader(i);
+						mStageStatistics.add(OPENPOSE_STAGE_PRODUCER, getTimestampNs() - loadBeginNs);
+					}
+					catch (const std::exception& e)
+					{
+						op::log(e.what(), op::Priority::Max, __LINE__, __FUNCTION__, __FILE__);
+					}
+					{
+						std::unique_lock<std::mutex> lock{mMutex};
+						mConditionVariable.wait(lock, [this]{ return mLoadedImages.size() < mMaxLoadedImages; });
+						mLoadedImages.emplace_back(i, std::move(cvMat));
+						numberPushed++;
+					}
+					mConditionVariable.notify_all();
+				}
+				std::unique_lock<std::mutex> lock{mMutex};
+				mConditionVariable.wait(lock, [this, numberImages]{ return mNumberProcessed == numberImages; });
+				pFrames = nullptr;
+				return mNumberSucceeded;
+			}
+			catch (const std::exception& e)
+			{
+				if (numberPushed >= 0)
+					releaseFrames(numberPushed);
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+				return 0;
+			}
+		}
+
+		/**
+		 * Durations of each step of process() (see OpenPoseStage).
+		 */
+		const StageStatistics& getStageStatistics() const
+		{
+			return mStageStatistics;
+		}
+
+	private:
+		const int mNumberBodyParts;
+		const unsigned int mMaxLoadedImages;
+		// Only used on the engine thread
+		ScalePlanCache mScalePlanCache;
+		FusedCvMatToOpInput mFusedCvMatToOpInput;
+		// Net input, reused from image to image (only reallocated when the net input size changes)
+		op::Array<float> mNetInputArray;
+		const op::ScaleMode mKeypointScale;
+		const std::unique_ptr<PoseEngine> upPoseEngine;
+		// Thread-safe
+		StageStatistics mStageStatistics;
+		// Serializes process()
+		std::mutex mProcessMutex;
+		// Everything below is guarded by mMutex
+		std::mutex mMutex;
+		std::condition_variable mConditionVariable;
+		bool mIsInitialized;
+		std::string mInitializationError;
+		bool mIsStopped;
+		OpenPoseKeypointFrame* pFrames;
+		std::deque<std::pair<int, cv::Mat>> mLoadedImages;
+		int mNumberProcessed;
+		int mNumberSucceeded;
+		// Started once every other member is constructed
+		std::thread mEngineThread;
+
+		static std::unique_ptr<PoseEngine> createPoseEngine(const BatchConfiguration& batchConfiguration)
+		{
+			if (batchConfiguration.shareWeights && batchConfiguration.poseEngine != OPENPOSE_POSE_ENGINE_CAFFE)
+				op::error("Weight sharing is only implemented for the Caffe pose engine.", __LINE__, __FUNCTION__,
+					__FILE__);
+			if (batchConfiguration.poseEngine == OPENPOSE_POSE_ENGINE_OPENCV)
+				return std::unique_ptr<PoseEngine>{new PoseEngineOpenCv{batchConfiguration.poseModel,
+					batchConfiguration.modelFolder}};
+			if (batchConfiguration.poseEngine == OPENPOSE_POSE_ENGINE_OPENCV_INT8)
+			{
+				if (batchConfiguration.int8CalibrationPath.empty())
+					op::error("The int8 pose engine requires an int8 calibration file.", __LINE__, __FUNCTION__, __FILE__);
+				return std::unique_ptr<PoseEngine>{new PoseEngineOpenCv{batchConfiguration.poseModel,
+					batchConfiguration.modelFolder, batchConfiguration.int8CalibrationPath}};
+			}
+			if (batchConfiguration.poseEngine != OPENPOSE_POSE_ENGINE_CAFFE)
+				op::error("Unknown pose engine: " + std::to_string((int)batchConfiguration.poseEngine) + ".",
+					__LINE__, __FUNCTION__, __FILE__);
+			if (batchConfiguration.shareWeights)
+				return std::unique_ptr<PoseEngine>{new PoseEngineCaffeSharedWeights{batchConfiguration.poseModel,
+					batchConfiguration.modelFolder, batchConfiguration.gpuNumberStart}};
+			return std::unique_ptr<PoseEngine>{new PoseEngineCaffe{batchConfiguration.poseModel,
+				batchConfiguration.modelFolder, batchConfiguration.gpuNumberStart}};
+		}
+
+		void engineLoop()
+		{
+			try
+			{
+				upPoseEngine->initializationOnThread();
+			}
+			catch (const std::exception& e)
+			{
+				const std::lock_guard<std::mutex> lock{mMutex};
+				mInitializationError = e.what();
+			}
+			{
+				const std::lock_guard<std::mutex> lock{mMutex};
+				mIsInitialized = true;
+			}
+			mConditionVariable.notify_all();
+			while (mInitializationError.empty())
+			{
+				std::pair<int, cv::Mat> loadedImage;
+				OpenPoseKeypointFrame* frames;
+				{
+					std::unique_lock<std::mutex> lock{mMutex};
+					mConditionVariable.wait(lock, [this]{ return mIsStopped || !mLoadedImages.empty(); });
+					if (mIsStopped)
+						return;
+					loadedImage = std::move(mLoadedImages.front());
+					mLoadedImages.pop_front();
+					frames = pFrames;
+				}
+				// There is room for the next image
+				mConditionVariable.notify_all();
+				const auto succeeded = extract(loadedImage.second, frames[loadedImage.first], loadedImage.first);
+				{
+					const std::lock_guard<std::mutex> lock{mMutex};
+					mNumberProcessed++;
+					if (succeeded)
+						mNumberSucceeded++;
+				}
+				mConditionVariable.notify_all();
+			}
+		}
+
+		// Called if process() fails halfway: it drops the images the engine thread has not taken yet and waits for the
+		// one it may be writing, so that the caller's frames are not touched after process() returns
+		void releaseFrames(const int numberPushed)
+		{
+			std::unique_lock<std::mutex> lock{mMutex};
+			mNumberProcessed += (int)mLoadedImages.size();
+			mLoadedImages.clear();
+			mConditionVariable.notify_all();
+			mConditionVariable.wait(lock, [this, numberPushed]{
+				return mIsStopped || mNumberProcessed >= numberPushed;
+			});
+			pFrames = nullptr;
+		}
+
+		bool extract(const cv::Mat& cvInputData, OpenPoseKeypointFrame& frame, const int index)
+		{
+			try
+			{
+				const auto beginNs = getTimestampNs();
+				frame.frameId = (unsigned long long)index;
+				frame.inputTimestampNs = beginNs;
+				frame.numberPeople = -1;
+				frame.numberBodyParts = mNumberBodyParts;
+				frame.numberFaceParts = 0;
+				frame.numberHandParts = 0;
+				if (cvInputData.empty())
+				{
+					op::log("Image " + std::to_string(index) + " could not be read.", op::Priority::High);
+					frame.timestampNs = getTimestampNs();
+					return false;
+				}
+				// Same steps as tutorial_pose/2_extract_pose_or_heatmat_from_image.cpp, without the initialization
+				const op::Point<int> imageSize{cvInputData.cols, cvInputData.rows};
+				const auto& scalePlan = mScalePlanCache.extract(imageSize);
+				mFusedCvMatToOpInput.createArray(mNetInputArray, cvInputData, scalePlan.scaleInputToNetInputs,
+					scalePlan.netInputSizes);
+				const auto inputConversionEndNs = getTimestampNs();
+				mStageStatistics.add(OPENPOSE_STAGE_INPUT_CONVERSION, inputConversionEndNs - beginNs);
+				upPoseEngine->forwardPass(mNetInputArray, imageSize, scalePlan.scaleInputToNetInputs);
+				const auto& poseKeypoints = upPoseEngine->getPoseKeypoints();
+				const auto networkEndNs = getTimestampNs();
+				mStageStatistics.add(OPENPOSE_STAGE_NETWORK, networkEndNs - inputConversionEndNs);
+				upPoseEngine->addStepDurations(mStageStatistics);
+				// Scaled (from input resolution) while copied to the host buffers, so the extractor keypoints are
+				// neither cloned nor modified
+				const auto numberPeople = (poseKeypoints.empty()
+					? 0 : std::min(poseKeypoints.getSize(0), std::max(frame.maxPeople, 0)));
+				if (frame.poseKeypoints != nullptr && numberPeople > 0)
+					transformKeypoints(frame.poseKeypoints, poseKeypoints.getConstPtr(), numberPeople * mNumberBodyParts,
+						getKeypointScaleTransform(mKeypointScale, scalePlan.scaleInputToOutput,
+							upPoseEngine->getScaleNetToOutput(), imageSize, true));
+				mStageStatistics.add(OPENPOSE_STAGE_KEYPOINT_SCALING, getTimestampNs() - networkEndNs);
+				frame.numberPeople = numberPeople;
+				frame.timestampNs = getTimestampNs();
+				mStageStatistics.add(OPENPOSE_STAGE_TOTAL, frame.timestampNs - beginNs);
+				return true;
+			}
+			catch (const std::exception& e)
+			{
+				// A wrong image must not stop the whole batch
+				op::log(e.what(), op::Priority::Max, __LINE__, __FUNCTION__, __FILE__);
+				frame.numberPeople = -1;
+				frame.timestampNs = getTimestampNs();
+				return false;
+			}
+		}
+
+		DELETE_COPY(BatchExtractor);
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_BATCH_EXTRACTOR_HPP
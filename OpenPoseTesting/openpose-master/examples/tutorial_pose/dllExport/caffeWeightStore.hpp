@@ -0,0 +1,82 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_CAFFE_WEIGHT_STORE_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_CAFFE_WEIGHT_STORE_HPP
+
+// C++ std library dependencies
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+// Caffe dependencies
+#ifdef USE_CAFFE
+	#include <caffe/net.hpp>
+#endif
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+
+namespace dllExport
+{
+	#ifdef USE_CAFFE
+		/**
+		 * CaffeWeightStore: process-wide table of the loaded caffemodel weights, so that several networks built from
+		 * the same prototxt (e.g. one per worker thread) read a single copy of them. Each weight owner is a caffe::Net
+		 * that is never run: the networks that use it only share its parameter blobs
+		 * (caffe::Net::ShareTrainedLayersWith) and keep their own activation blobs, so they can run in parallel. The
+		 * owner is freed with its last user.
+		 * The weights are copied to the device (or to the CPU) once, while loading, so that the concurrent forward
+		 * passes only read them (caffe::SyncedMemory changes its state on the first access). A GPU owner is tied to
+		 * its device, so the weights are shared per GPU.
+		 * The caller thread must have set the Caffe mode (and device) of `gpuId` before acquire().
+		 */
+		class CaffeWeightStore
+		{
+		public:
+			static CaffeWeightStore& getInstance()
+			{
+				static CaffeWeightStore caffeWeightStore;
+				return caffeWeightStore;
+			}
+
+			std::shared_ptr<caffe::Net<float>> acquire(const std::string& prototxtPath,
+				const std::string& caffeModelPath, const int gpuId)
+			{
+				try
+				{
+					const std::lock_guard<std::mutex> lock{mMutex};
+					const auto key = prototxtPath + "\n" + caffeModelPath + "\n" + std::to_string(gpuId);
+					auto spWeightOwner = mWeightOwners[key].lock();
+					if (spWeightOwner == nullptr)
+					{
+						op::log("Loading " + caffeModelPath + " into the shared weight store.", op::Priority::High);
+						spWeightOwner = std::make_shared<caffe::Net<float>>(prototxtPath, caffe::TEST);
+						spWeightOwner->CopyTrainedLayersFrom(caffeModelPath);
+						for (const auto& spParam : spWeightOwner->params())
+						{
+							#ifdef USE_CUDA
+								spParam->gpu_data();
+							#else
+								spParam->cpu_data();
+							#endif
+						}
+						mWeightOwners[key] = spWeightOwner;
+					}
+					return spWeightOwner;
+				}
+				catch (const std::exception& e)
+				{
+					op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+					return nullptr;
+				}
+			}
+
+		private:
+			std::mutex mMutex;
+			std::map<std::string, std::weak_ptr<caffe::Net<float>>> mWeightOwners;
+
+			CaffeWeightStore() = default;
+
+			DELETE_COPY(CaffeWeightStore);
+		};
+	#endif
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_CAFFE_WEIGHT_STORE_HPP
@@ -0,0 +1,83 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_COPY_STATISTICS_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_COPY_STATISTICS_HPP
+
+// C++ std library dependencies
+#include <atomic>
+#include <string>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+
+namespace dllExport
+{
+	/**
+	 * CopyStatistics: process-wide counters of the copies made while the frames travel through the pipelines.
+	 * The datums are meant to be moved from queue to queue (only the std::shared_ptr of each batch is passed around), so
+	 * any HostDatum copy (copy constructor or copy assignment) is counted as a datum copy. Any full copy of a frame buffer
+	 * (e.g. cvInputData no longer pointing to the pushed host memory, or a cvOutputData duplicated to outlive it) is
+	 * counted as a payload copy. In debug builds, the first occurrence of each kind is also logged.
+	 */
+	class CopyStatistics
+	{
+	public:
+		static CopyStatistics& getInstance()
+		{
+			static CopyStatistics copyStatistics;
+			return copyStatistics;
+		}
+
+		void addDatumCopy()
+		{
+			#ifndef NDEBUG
+				if (mNumberDatumCopies.fetch_add(1ull) == 0ull)
+					op::log("A Datum was copied instead of moved between pipeline stages.", op::Priority::High,
+						__LINE__, __FUNCTION__, __FILE__);
+			#else
+				mNumberDatumCopies++;
+			#endif
+		}
+
+		void addPayloadCopy(const unsigned long long numberBytes, const std::string& description)
+		{
+			mNumberPayloadBytes += numberBytes;
+			#ifndef NDEBUG
+				if (mNumberPayloadCopies.fetch_add(1ull) == 0ull)
+					op::log("Frame payload copied (" + description + ").", op::Priority::High,
+						__LINE__, __FUNCTION__, __FILE__);
+			#else
+				(void)description;
+				mNumberPayloadCopies++;
+			#endif
+		}
+
+		unsigned long long getNumberDatumCopies() const
+		{
+			return mNumberDatumCopies;
+		}
+
+		unsigned long long getNumberPayloadCopies() const
+		{
+			return mNumberPayloadCopies;
+		}
+
+		unsigned long long getNumberPayloadBytes() const
+		{
+			return mNumberPayloadBytes;
+		}
+
+	private:
+		std::atomic<unsigned long long> mNumberDatumCopies;
+		std::atomic<unsigned long long> mNumberPayloadCopies;
+		std::atomic<unsigned long long> mNumberPayloadBytes;
+
+		CopyStatistics() :
+			mNumberDatumCopies{0ull},
+			mNumberPayloadCopies{0ull},
+			mNumberPayloadBytes{0ull}
+		{
+		}
+
+		DELETE_COPY(CopyStatistics);
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_COPY_STATISTICS_HPP
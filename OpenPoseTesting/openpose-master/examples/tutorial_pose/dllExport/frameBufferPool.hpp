@@ -0,0 +1,209 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_FRAME_BUFFER_POOL_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_FRAME_BUFFER_POOL_HPP
+
+// C++ std library dependencies
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <new> // placement new
+#include <vector>
+// OpenPose dependencies
+#include <opencv2/core/core.hpp>
+#include <opencv2/core/version.hpp>
+#include <openpose/headers.hpp>
+
+namespace dllExport
+{
+	/**
+	 * FrameBufferPool: size-class pool of the full-frame cv::Mat buffers allocated by the DLL on every frame (converted
+	 * host frames, pyramid levels, 8-bit output frames...).
+	 * It is a cv::MatAllocator, so the pooled cv::Mat are regular reference-counted cv::Mat that can be copied and passed
+	 * to OpenPose and OpenCV as usual: the buffer goes back to the pool when the last cv::Mat referencing it is
+	 * destroyed, from whichever thread that happens. Since video frames keep their size, after the first frames every
+	 * allocation is served from the pool (a hit) without touching the heap, neither for the buffer nor for its
+	 * cv::UMatData header.
+	 * Usage: `cv::Mat cvMat; cvMat.allocator = &FrameBufferPool::getInstance();` before any function that creates it.
+	 * What it does not cover: op::Array allocates its own storage (not through cv::MatAllocator), so the arrays of
+	 * each op::Datum (inputNetData, outputData, keypoints, heat maps) are still allocated per frame by the OpenPose
+	 * library, as are the op::Datum themselves and the results of the pose extractor (e.g. connectBodyPartsCpu). The
+	 * batch API avoids the largest of them by re-using its net input array (FusedCvMatToOpInput::createArray).
+	 */
+	class FrameBufferPool : public cv::MatAllocator
+	{
+	public:
+		// cv::MatAllocator access flags: a plain int until OpenCV 3, cv::AccessFlag since OpenCV 4
+		#if CV_MAJOR_VERSION >= 4
+			typedef cv::AccessFlag AccessFlags;
+		#else
+			typedef int AccessFlags;
+		#endif
+
+		/**
+		 * The pool is never destroyed: pooled cv::Mat may outlive any static object (e.g. the cached sessions, see
+		 * SessionCache), and their destructor calls deallocate().
+		 */
+		static FrameBufferPool& getInstance()
+		{
+			static auto* const frameBufferPool = new FrameBufferPool{};
+			return *frameBufferPool;
+		}
+
+		cv::UMatData* allocate(int dims, const int* sizes, int type, void* data0, size_t* step, AccessFlags flags,
+			cv::UMatUsageFlags usageFlags) const
+		{
+			try
+			{
+				// Wrapped external memory is not pooled
+				if (data0 != nullptr)
+					return cv::Mat::getDefaultAllocator()->allocate(dims, sizes, type, data0, step, flags, usageFlags);
+				// Same layout as cv::StdMatAllocator
+				auto total = (size_t)CV_ELEM_SIZE(type);
+				for (auto i = dims - 1 ; i >= 0 ; i--)
+				{
+					if (step != nullptr)
+						step[i] = total;
+					total *= (size_t)sizes[i];
+				}
+				const auto sizeClass = getSizeClass(total);
+				{
+					const std::lock_guard<std::mutex> lock{mMutex};
+					auto& idleBuffers = mIdleBuffers[sizeClass];
+					if (!idleBuffers.empty())
+					{
+						auto* const uMatData = idleBuffers.back();
+						idleBuffers.pop_back();
+						mNumberIdleBytes -= sizeClass;
+						mNumberHits++;
+						uMatData->size = total;
+						return uMatData;
+					}
+				}
+				mNumberMisses++;
+				auto* const uMatData = new cv::UMatData{this};
+				uMatData->data = uMatData->origdata = (unsigned char*)cv::fastMalloc(sizeClass);
+				uMatData->size = total;
+				return uMatData;
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+				return nullptr;
+			}
+		}
+
+		bool allocate(cv::UMatData* uMatData, AccessFlags, cv::UMatUsageFlags) const
+		{
+			return uMatData != nullptr;
+		}
+
+		void deallocate(cv::UMatData* uMatData) const
+		{
+			try
+			{
+				if (uMatData == nullptr)
+					return;
+				auto* const buffer = uMatData->origdata;
+				const auto sizeClass = getSizeClass(uMatData->size);
+				// Reset the header for its next cv::Mat
+				uMatData->~UMatData();
+				new (uMatData) cv::UMatData{this};
+				uMatData->data = uMatData->origdata = buffer;
+				{
+					const std::lock_guard<std::mutex> lock{mMutex};
+					auto& idleBuffers = mIdleBuffers[sizeClass];
+					if (idleBuffers.size() < sMaxIdleBuffersPerClass
+						&& mNumberIdleBytes + sizeClass <= sMaxIdleBytes)
+					{
+						idleBuffers.emplace_back(uMatData);
+						mNumberIdleBytes += sizeClass;
+						return;
+					}
+				}
+				cv::fastFree(buffer);
+				delete uMatData;
+			}
+			catch (const std::exception& e)
+			{
+				op::log(e.what(), op::Priority::Max, __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+		/**
+		 * It frees every idle buffer. The buffers in use go back to the pool as usual.
+		 */
+		void clear()
+		{
+			try
+			{
+				std::map<size_t, std::vector<cv::UMatData*>> idleBuffers;
+				{
+					const std::lock_guard<std::mutex> lock{mMutex};
+					std::swap(idleBuffers, mIdleBuffers);
+					mNumberIdleBytes = 0;
+				}
+				for (auto& sizeClassBuffers : idleBuffers)
+				{
+					for (auto* uMatData : sizeClassBuffers.second)
+					{
+						cv::fastFree(uMatData->origdata);
+						delete uMatData;
+					}
+				}
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+		unsigned long long getNumberHits() const
+		{
+			return mNumberHits;
+		}
+
+		unsigned long long getNumberMisses() const
+		{
+			return mNumberMisses;
+		}
+
+		unsigned long long getNumberIdleBytes() const
+		{
+			const std::lock_guard<std::mutex> lock{mMutex};
+			return mNumberIdleBytes;
+		}
+
+	private:
+		// Enough for the frames in flight of a few sessions, bounded so a burst of odd sizes cannot pin memory
+		static const size_t sMaxIdleBuffersPerClass = 8;
+		static const unsigned long long sMaxIdleBytes = 512ull << 20;
+
+		mutable std::mutex mMutex;
+		mutable std::map<size_t, std::vector<cv::UMatData*>> mIdleBuffers;
+		mutable unsigned long long mNumberIdleBytes;
+		mutable std::atomic<unsigned long long> mNumberHits;
+		mutable std::atomic<unsigned long long> mNumberMisses;
+
+		FrameBufferPool() :
+			mNumberIdleBytes{0ull},
+			mNumberHits{0ull},
+			mNumberMisses{0ull}
+		{
+		}
+
+		// 4 size classes per power of two (at most 25% wasted), from 4 KB
+		static size_t getSizeClass(const size_t size)
+		{
+			if (size <= 4096)
+				return 4096;
+			auto powerOfTwo = (size_t)4096;
+			while (powerOfTwo < size)
+				powerOfTwo <<= 1;
+			const auto granularity = powerOfTwo / 8;
+			return (size + granularity - 1) / granularity * granularity;
+		}
+
+		DELETE_COPY(FrameBufferPool);
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_FRAME_BUFFER_POOL_HPP
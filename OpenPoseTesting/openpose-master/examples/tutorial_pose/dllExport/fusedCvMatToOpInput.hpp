@@ -0,0 +1,315 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_FUSED_CV_MAT_TO_OP_INPUT_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_FUSED_CV_MAT_TO_OP_INPUT_HPP
+
+// C++ std library dependencies
+#include <algorithm> // std::copy, std::fill, std::min
+#include <cmath> // std::ceil, std::floor
+#include <cstring> // std::memcpy
+#include <exception> // std::exception_ptr
+#include <vector>
+// SIMD dependencies (selected at compile time, e.g. -mavx2 or /arch:AVX2)
+#if defined(__AVX2__)
+	#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define OPENPOSE_DLL_EXPORT_SSE2
+#endif
+// OpenPose dependencies
+#include <opencv2/imgproc/imgproc.hpp> // cv::resize
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "arrayView.hpp"
+#include "frameBufferPool.hpp"
+
+namespace dllExport
+{
+	/**
+	 * FusedCvMatToOpInput: drop-in replacement of op::CvMatToOpInput::createArray for 8-bit BGR frames.
+	 * op::CvMatToOpInput resizes each scale (op::resizeFixedAspectRatio), and then converts it to float, normalizes it
+	 * to [-0.5, 0.5) and reorders it from interleaved BGR into planar channels in separate passes. This class does all
+	 * of it in a single pass over each output row: the two source rows are blended vertically into a float row buffer,
+	 * and each output pixel is then blended horizontally, normalized and written straight into its channel plane. The
+	 * vertical blend uses SSE2 or AVX2 and the horizontal one uses AVX2 gathers, with scalar fallbacks.
+	 * Differences with op::CvMatToOpInput: it interpolates bilinearly (instead of bicubic), and the padding of each
+	 * scale is written directly as -0.5, i.e. the normalized value of the black border.
+	 * Multi-scale: instead of resizing the full input once per scale, the scales are built as an 8-bit pyramid, each
+	 * level resized (cv::INTER_AREA) from the previous one, and the levels are then converted to float in parallel by
+	 * the OpenMP threads, which persist from frame to frame (so no thread is created per frame).
+	 * The row buffers and coefficient tables are aligned (AlignedBuffer), so the SIMD loops load and store them with
+	 * aligned instructions, and every scale is written through a view (ArrayView::slice) of the output array.
+	 * The coefficient tables of each scale only depend on the source size, the scale and the target size, so they are
+	 * kept from one call to the next and only rebuilt when one of them changes (i.e. never for a fixed-size video).
+	 * Not thread-safe: it reuses its row buffers and coefficient tables between calls.
+	 */
+	class FusedCvMatToOpInput
+	{
+	public:
+		op::Array<float> createArray(const cv::Mat& cvInputData, const std::vector<double>& scaleInputToNetInputs,
+			const std::vector<op::Point<int>>& netInputSizes)
+		{
+			try
+			{
+				op::Array<float> inputNetData;
+				createArray(inputNetData, cvInputData, scaleInputToNetInputs, netInputSizes);
+				return inputNetData;
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+				return op::Array<float>{};
+			}
+		}
+
+		/**
+		 * Same as the function above, but written into `inputNetData`, which is only reallocated if its size differs
+		 * from the new one. Re-using the same op::Array from frame to frame (while nothing else keeps a copy of it)
+		 * avoids allocating the net input of each frame.
+		 */
+		void createArray(op::Array<float>& inputNetData, const cv::Mat& cvInputData,
+			const std::vector<double>& scaleInputToNetInputs, const std::vector<op::Point<int>>& netInputSizes)
+		{
+			try
+			{
+				// Security checks
+				if (cvInputData.empty())
+					op::error("Wrong input element (empty cvInputData).", __LINE__, __FUNCTION__, __FILE__);
+				if (cvInputData.type() != CV_8UC3)
+					op::error("Input images must be 3-channel BGR.", __LINE__, __FUNCTION__, __FILE__);
+				if (scaleInputToNetInputs.size() != netInputSizes.size() || netInputSizes.empty())
+					op::error("scaleInputToNetInputs.size() != netInputSizes.size().", __LINE__, __FUNCTION__, __FILE__);
+				// Same layout as op::CvMatToOpInput: one 3xHxW block per scale, all with the size of the first one
+				const auto numberScales = (int)scaleInputToNetInputs.size();
+				const auto netInputSize = netInputSizes.at(0);
+				const std::vector<int> inputNetDataSize{numberScales, 3, netInputSize.y, netInputSize.x};
+				if (inputNetData.getSize() != inputNetDataSize)
+					inputNetData.reset(inputNetDataSize);
+				const ArrayView<float> inputNetView{inputNetData};
+				if ((int)mConversionBuffers.size() < numberScales)
+					mConversionBuffers.resize(numberScales);
+				// Single scale: fused resize from the input
+				if (numberScales == 1)
+				{
+					resizeNormalizeToPlanar(inputNetView.slice(0), cvInputData, scaleInputToNetInputs[0],
+						mConversionBuffers[0]);
+					return;
+				}
+				// Multi-scale: pyramid
+				std::vector<cv::Mat> levels(numberScales);
+				cv::Mat previousLevel = cvInputData;
+				auto previousScale = 1.;
+				for (auto i = 0 ; i < numberScales ; i++)
+				{
+					const auto scale = scaleInputToNetInputs[i];
+					// Only downscaling is derived from the previous level, a bigger scale starts again from the input
+					if (scale > previousScale)
+					{
+						previousLevel = cvInputData;
+						previousScale = 1.;
+					}
+					auto& level = levels[i];
+					level.allocator = &FrameBufferPool::getInstance();
+					const cv::Size levelSize{std::max(1, (int)std::ceil(cvInputData.cols * scale)),
+						std::max(1, (int)std::ceil(cvInputData.rows * scale))};
+					if (levelSize.width == previousLevel.cols && levelSize.height == previousLevel.rows)
+						level = previousLevel;
+					else
+						cv::resize(previousLevel, level, levelSize, 0, 0, cv::INTER_AREA);
+					previousLevel = level;
+					previousScale = scale;
+				}
+				// Levels split across the OpenMP threads. Exceptions cannot leave the parallel loop, so the first one is
+				// kept and re-thrown after it
+				std::exception_ptr exceptionPtr;
+				#pragma omp parallel for schedule(dynamic)
+				for (auto i = 0 ; i < numberScales ; i++)
+				{
+					try
+					{
+						resizeNormalizeToPlanar(inputNetView.slice(i), levels[i], 1., mConversionBuffers[i]);
+					}
+					catch (const std::exception&)
+					{
+						#pragma omp critical(fusedCvMatToOpInputException)
+						if (!exceptionPtr)
+							exceptionPtr = std::current_exception();
+					}
+				}
+				if (exceptionPtr)
+					std::rethrow_exception(exceptionPtr);
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+	private:
+		struct ConversionBuffers
+		{
+			// Interleaved float copy of the vertically blended source row, plus a duplicate of its last pixel
+			AlignedBuffer<float> rowBuffer;
+			// Horizontal coefficients of each output column: first source float (3 * x0) and weight of the second pixel
+			AlignedBuffer<int> columnIndexes;
+			AlignedBuffer<float> columnWeights;
+			// Vertical coefficients of each output row: first source row (y0) and weight of the second one
+			AlignedBuffer<int> rowIndexes;
+			AlignedBuffer<float> rowWeights;
+			// Arguments the coefficient tables were computed for
+			int tableSourceWidth = -1;
+			int tableSourceHeight = -1;
+			double tableScale = 0.;
+			int tableWidth = -1;
+			int tableHeight = -1;
+		};
+
+		// One per scale, so the scales can be converted in parallel
+		std::vector<ConversionBuffers> mConversionBuffers;
+
+		// Output (x, y) samples the source at (x / scale, y / scale), as the scale-only affine transform of
+		// op::resizeFixedAspectRatio. Output pixels that fall outside the source are padding. `target` is a 3xHxW view.
+		static void resizeNormalizeToPlanar(const ArrayView<float>& target, const cv::Mat& source, const double scale,
+			ConversionBuffers& conversionBuffers)
+		{
+			auto& rowBuffer = conversionBuffers.rowBuffer;
+			auto* const targetPtr = target.getPtr();
+			const op::Point<int> targetSize{target.getSize(2), target.getSize(1)};
+			const auto targetArea = targetSize.area();
+			// Padding value: the normalized black pixel
+			std::fill(targetPtr, targetPtr + 3 * targetArea, -0.5f);
+			if (scale <= 0.)
+				return;
+			const auto width = std::min(targetSize.x, (int)std::ceil(source.cols * scale));
+			const auto height = std::min(targetSize.y, (int)std::ceil(source.rows * scale));
+			if (width <= 0 || height <= 0)
+				return;
+			updateCoefficientTables(conversionBuffers, source.cols, source.rows, scale, width, height);
+			const auto* const rowIndexes = conversionBuffers.rowIndexes.data();
+			const auto* const rowWeights = conversionBuffers.rowWeights.data();
+			rowBuffer.resize(3 * (source.cols + 1));
+			float* planes[3]{target.slice(0).getPtr(), target.slice(1).getPtr(), target.slice(2).getPtr()};
+			for (auto y = 0 ; y < height ; y++)
+			{
+				const auto y0 = rowIndexes[y];
+				const auto y1 = std::min(y0 + 1, source.rows - 1);
+				blendRows(rowBuffer.data(), source.ptr<unsigned char>(y0), source.ptr<unsigned char>(y1),
+					rowWeights[y], 3 * source.cols);
+				// x0 + 1 never goes past the row
+				auto* const rowEnd = rowBuffer.data() + rowBuffer.size();
+				std::copy(rowEnd - 6, rowEnd - 3, rowEnd - 3);
+				const auto rowOffset = y * targetSize.x;
+				blendColumns(planes[0] + rowOffset, planes[1] + rowOffset, planes[2] + rowOffset, width,
+					conversionBuffers);
+			}
+		}
+
+		static void updateCoefficientTables(ConversionBuffers& conversionBuffers, const int sourceWidth,
+			const int sourceHeight, const double scale, const int width, const int height)
+		{
+			if (conversionBuffers.tableSourceWidth == sourceWidth && conversionBuffers.tableSourceHeight == sourceHeight
+				&& conversionBuffers.tableScale == scale && conversionBuffers.tableWidth == width
+				&& conversionBuffers.tableHeight == height)
+				return;
+			auto& columnIndexes = conversionBuffers.columnIndexes;
+			auto& columnWeights = conversionBuffers.columnWeights;
+			columnIndexes.resize(width);
+			columnWeights.resize(width);
+			for (auto x = 0 ; x < width ; x++)
+			{
+				const auto sourceX = std::min(x / scale, sourceWidth - 1.);
+				const auto x0 = (int)std::floor(sourceX);
+				columnIndexes[x] = 3 * x0;
+				columnWeights[x] = (float)(sourceX - x0);
+			}
+			auto& rowIndexes = conversionBuffers.rowIndexes;
+			auto& rowWeights = conversionBuffers.rowWeights;
+			rowIndexes.resize(height);
+			rowWeights.resize(height);
+			for (auto y = 0 ; y < height ; y++)
+			{
+				const auto sourceY = std::min(y / scale, sourceHeight - 1.);
+				const auto y0 = (int)std::floor(sourceY);
+				rowIndexes[y] = y0;
+				rowWeights[y] = (float)(sourceY - y0);
+			}
+			conversionBuffers.tableSourceWidth = sourceWidth;
+			conversionBuffers.tableSourceHeight = sourceHeight;
+			conversionBuffers.tableScale = scale;
+			conversionBuffers.tableWidth = width;
+			conversionBuffers.tableHeight = height;
+		}
+
+		// target[i] = row0[i] + weight1 * (row1[i] - row0[i]), with `target` aligned to BUFFER_ALIGNMENT
+		static void blendRows(float* target, const unsigned char* row0, const unsigned char* row1, const float weight1,
+			const int size)
+		{
+			auto i = 0;
+			#if defined(__AVX2__)
+				const auto weight = _mm256_set1_ps(weight1);
+				for ( ; i + 8 <= size ; i += 8)
+				{
+					const auto value0 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(
+						_mm_loadl_epi64((const __m128i*)(row0 + i))));
+					const auto value1 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(
+						_mm_loadl_epi64((const __m128i*)(row1 + i))));
+					_mm256_store_ps(target + i,
+						_mm256_add_ps(value0, _mm256_mul_ps(weight, _mm256_sub_ps(value1, value0))));
+				}
+			#elif defined(OPENPOSE_DLL_EXPORT_SSE2)
+				const auto weight = _mm_set1_ps(weight1);
+				const auto zero = _mm_setzero_si128();
+				for ( ; i + 4 <= size ; i += 4)
+				{
+					// 4 bytes -> 4 x int32 -> 4 x float
+					int bytes0, bytes1;
+					std::memcpy(&bytes0, row0 + i, 4);
+					std::memcpy(&bytes1, row1 + i, 4);
+					const auto value0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(
+						_mm_cvtsi32_si128(bytes0), zero), zero));
+					const auto value1 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(
+						_mm_cvtsi32_si128(bytes1), zero), zero));
+					_mm_store_ps(target + i, _mm_add_ps(value0, _mm_mul_ps(weight, _mm_sub_ps(value1, value0))));
+				}
+			#endif
+			for ( ; i < size ; i++)
+				target[i] = row0[i] + weight1 * (row1[i] - row0[i]);
+		}
+
+		// Horizontal blend of the row buffer, normalization (x / 256 - 0.5) and BGR deinterleaving. The coefficient tables
+		// are aligned, the planes (inside the op::Array) are not
+		static void blendColumns(float* plane0, float* plane1, float* plane2, const int width,
+			const ConversionBuffers& conversionBuffers)
+		{
+			const auto* const rowBuffer = conversionBuffers.rowBuffer.data();
+			const auto* const columnIndexes = conversionBuffers.columnIndexes.data();
+			const auto* const columnWeights = conversionBuffers.columnWeights.data();
+			auto x = 0;
+			#if defined(__AVX2__)
+				const auto normalization = _mm256_set1_ps(1.f / 256.f);
+				const auto offset = _mm256_set1_ps(0.5f);
+				for ( ; x + 8 <= width ; x += 8)
+				{
+					const auto indexes = _mm256_load_si256((const __m256i*)(columnIndexes + x));
+					const auto weights = _mm256_load_ps(columnWeights + x);
+					float* planes[3]{plane0, plane1, plane2};
+					for (auto c = 0 ; c < 3 ; c++)
+					{
+						const auto left = _mm256_i32gather_ps(rowBuffer + c, indexes, 4);
+						const auto right = _mm256_i32gather_ps(rowBuffer + 3 + c, indexes, 4);
+						const auto value = _mm256_add_ps(left, _mm256_mul_ps(weights, _mm256_sub_ps(right, left)));
+						_mm256_storeu_ps(planes[c] + x, _mm256_sub_ps(_mm256_mul_ps(value, normalization), offset));
+					}
+				}
+			#endif
+			for ( ; x < width ; x++)
+			{
+				const auto* const left = rowBuffer + columnIndexes[x];
+				const auto weight = columnWeights[x];
+				plane0[x] = (left[0] + weight * (left[3] - left[0])) / 256.f - 0.5f;
+				plane1[x] = (left[1] + weight * (left[4] - left[1])) / 256.f - 0.5f;
+				plane2[x] = (left[2] + weight * (left[5] - left[2])) / 256.f - 0.5f;
+			}
+		}
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_FUSED_CV_MAT_TO_OP_INPUT_HPP
@@ -0,0 +1,98 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_HEAT_MAP_CALLBACK_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_HEAT_MAP_CALLBACK_HPP
+
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "../dllExportFile.hpp"
+#include "arrayView.hpp"
+#include "heatMapConversion.hpp"
+
+namespace dllExport
+{
+	/**
+	 * HeatMapCallback: host function called with the body pose heat maps (op::Datum::poseHeatMaps) of each processed
+	 * frame, converted to `format` (OpenPoseHeatmapFormat).
+	 * The float32 format points to the datum memory. The float16 and uint8 ones are converted into a buffer owned by
+	 * this class, reused from frame to frame, so the host never gets (nor waits for) a float copy. In every case, the
+	 * data is only valid during the call. It must always be called from the same thread.
+	 * Only what the host receives is compact: the library extracts op::Datum::poseHeatMaps as float and keeps them as
+	 * float through the whole pipeline, so this conversion happens at the end of it and the float heat maps are only
+	 * freed once it returns.
+	 */
+	class HeatMapCallback
+	{
+	public:
+		HeatMapCallback(const OpenPoseHeatmapCallback callback, void* const userData, const int format,
+			const op::ScaleMode heatMapScale) :
+			mCallback{callback},
+			pUserData{userData},
+			mFormat{format}
+		{
+			try
+			{
+				if (format != OPENPOSE_HEATMAP_FLOAT32 && format != OPENPOSE_HEATMAP_FLOAT16
+					&& format != OPENPOSE_HEATMAP_UINT8)
+					op::error("Unknown heatmap format.", __LINE__, __FUNCTION__, __FILE__);
+				getHeatMapQuantization(mQuantizationScale, mQuantizationOffset, heatMapScale);
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+		void fire(const op::Datum& datum)
+		{
+			try
+			{
+				const ArrayView<const float> heatMaps{datum.poseHeatMaps};
+				if (heatMaps.empty())
+					return;
+				const auto size = heatMaps.getVolume();
+				OpenPoseHeatmapFrame frame;
+				frame.frameId = datum.id;
+				frame.numberChannels = heatMaps.getSize(0);
+				frame.height = heatMaps.getSize(1);
+				frame.width = heatMaps.getSize(2);
+				frame.format = mFormat;
+				frame.quantizationScale = 1.f;
+				frame.quantizationOffset = 0.f;
+				if (mFormat == OPENPOSE_HEATMAP_FLOAT16)
+				{
+					mBuffer.resize(size * sizeof(unsigned short));
+					convertToHalf((unsigned short*)mBuffer.data(), heatMaps.getPtr(), size);
+					frame.data = mBuffer.data();
+				}
+				else if (mFormat == OPENPOSE_HEATMAP_UINT8)
+				{
+					mBuffer.resize(size);
+					convertToUnsignedChar(mBuffer.data(), heatMaps.getPtr(), size, mQuantizationScale,
+						mQuantizationOffset);
+					frame.data = mBuffer.data();
+					frame.quantizationScale = mQuantizationScale;
+					frame.quantizationOffset = mQuantizationOffset;
+				}
+				else
+					frame.data = heatMaps.getPtr();
+				mCallback(&frame, pUserData);
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+	private:
+		const OpenPoseHeatmapCallback mCallback;
+		void* const pUserData;
+		const int mFormat;
+		float mQuantizationScale;
+		float mQuantizationOffset;
+		AlignedBuffer<unsigned char> mBuffer;
+
+		DELETE_COPY(HeatMapCallback);
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_HEAT_MAP_CALLBACK_HPP
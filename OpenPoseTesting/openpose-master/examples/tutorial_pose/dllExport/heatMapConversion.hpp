@@ -0,0 +1,106 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_HEAT_MAP_CONVERSION_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_HEAT_MAP_CONVERSION_HPP
+
+// C++ std library dependencies
+#include <cstring> // std::memcpy
+// SIMD dependencies (selected at compile time, e.g. -mf16c, or /arch:AVX2 on MSVC)
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+	#include <immintrin.h>
+	#define OPENPOSE_DLL_EXPORT_F16C
+#endif
+// OpenPose dependencies
+#include <opencv2/core/core.hpp>
+#include <openpose/headers.hpp>
+
+namespace dllExport
+{
+	/**
+	 * Value range of the heat maps for each op::ScaleMode accepted by op::WrapperStructPose::heatMapScale, as
+	 * value = quantized * scale + offset for a uint8 `quantized` value covering the range.
+	 */
+	inline void getHeatMapQuantization(float& scale, float& offset, const op::ScaleMode heatMapScale)
+	{
+		if (heatMapScale == op::ScaleMode::PlusMinusOne)
+		{
+			scale = 2.f / 255.f;
+			offset = -1.f;
+		}
+		else if (heatMapScale == op::ScaleMode::ZeroToOne)
+		{
+			scale = 1.f / 255.f;
+			offset = 0.f;
+		}
+		// ScaleMode::UnsignedChar, already integers in [0, 255]
+		else
+		{
+			scale = 1.f;
+			offset = 0.f;
+		}
+	}
+
+	/**
+	 * IEEE 754 binary32 to binary16, rounding to nearest even, with overflow to infinity and NaN kept as NaN.
+	 */
+	inline unsigned short floatToHalf(const float value)
+	{
+		unsigned int bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		const auto sign = (unsigned short)((bits >> 16) & 0x8000u);
+		const auto absoluteBits = bits & 0x7fffffffu;
+		// Infinity or NaN
+		if (absoluteBits >= 0x7f800000u)
+			return (unsigned short)(sign | 0x7c00u | (absoluteBits > 0x7f800000u ? 0x200u : 0u));
+		// Rounds to 65520 or more: infinity
+		if (absoluteBits >= 0x477ff000u)
+			return (unsigned short)(sign | 0x7c00u);
+		// Below 2^-14: subnormal (or zero) half
+		if (absoluteBits < 0x38800000u)
+		{
+			if (absoluteBits < 0x33000000u)
+				return sign;
+			const auto mantissa = (absoluteBits & 0x7fffffu) | 0x800000u;
+			const auto shift = 126u - (absoluteBits >> 23);
+			const auto halfMantissa = mantissa >> shift;
+			const auto remainder = mantissa & ((1u << shift) - 1u);
+			const auto halfway = 1u << (shift - 1u);
+			return (unsigned short)(sign | (halfMantissa
+				+ (remainder > halfway || (remainder == halfway && (halfMantissa & 1u)) ? 1u : 0u)));
+		}
+		// Normal: exponent rebiased from 127 to 15 and mantissa rounded from 23 to 10 bits (a carry correctly bumps the
+		// exponent)
+		const auto rebiased = absoluteBits - 0x38000000u;
+		const auto halfBits = rebiased >> 13;
+		const auto remainder = rebiased & 0x1fffu;
+		return (unsigned short)(sign | (halfBits
+			+ (remainder > 0x1000u || (remainder == 0x1000u && (halfBits & 1u)) ? 1u : 0u)));
+	}
+
+	/**
+	 * It converts `size` floats into binary16 (F16C instructions if available).
+	 */
+	inline void convertToHalf(unsigned short* target, const float* source, const int size)
+	{
+		auto i = 0;
+		#ifdef OPENPOSE_DLL_EXPORT_F16C
+			for ( ; i + 8 <= size ; i += 8)
+				_mm_storeu_si128((__m128i*)(target + i),
+					_mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT));
+		#endif
+		for ( ; i < size ; i++)
+			target[i] = floatToHalf(source[i]);
+	}
+
+	/**
+	 * It quantizes `size` floats into uint8, with value = target * scale + offset (rounded to nearest, saturated).
+	 */
+	inline void convertToUnsignedChar(unsigned char* target, const float* source, const int size, const float scale,
+		const float offset)
+	{
+		// cv::Mat::convertTo rounds, saturates and is already vectorized
+		const cv::Mat sourceMat(1, size, CV_32FC1, const_cast<float*>(source));
+		cv::Mat targetMat(1, size, CV_8UC1, target);
+		sourceMat.convertTo(targetMat, CV_8U, 1. / scale, -offset / scale);
+	}
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_HEAT_MAP_CONVERSION_HPP
@@ -0,0 +1,152 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_HOST_DATUM_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_HOST_DATUM_HPP
+
+// C++ std library dependencies
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <utility> // std::move
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "copyStatistics.hpp"
+
+namespace dllExport
+{
+	/**
+	 * HostFrameTracker: number of host frames of a session whose HostFrameLease is not released yet, so the session can
+	 * wait until OpenPose no longer reads any host buffer (e.g. before it is handed over to another user).
+	 */
+	class HostFrameTracker
+	{
+	public:
+		HostFrameTracker() :
+			mNumberLeases{0ull}
+		{
+		}
+
+		void acquire()
+		{
+			const std::lock_guard<std::mutex> lock{mMutex};
+			mNumberLeases++;
+		}
+
+		void release()
+		{
+			{
+				const std::lock_guard<std::mutex> lock{mMutex};
+				mNumberLeases--;
+			}
+			mConditionVariable.notify_all();
+		}
+
+		/**
+		 * It waits at most `timeout` until every tracked lease is released (i.e. their host release functions have
+		 * returned).
+		 * @return Whether they are all released.
+		 */
+		bool waitForAll(const std::chrono::milliseconds timeout)
+		{
+			std::unique_lock<std::mutex> lock{mMutex};
+			return mConditionVariable.wait_for(lock, timeout, [this]{ return mNumberLeases == 0ull; });
+		}
+
+	private:
+		std::mutex mMutex;
+		std::condition_variable mConditionVariable;
+		unsigned long long mNumberLeases;
+
+		DELETE_COPY(HostFrameTracker);
+	};
+
+	/**
+	 * HostFrameLease: ownership token of a frame buffer that belongs to the host application.
+	 * The host release function is called exactly once, when the last copy of the token is destroyed, i.e. when no
+	 * Datum references the host memory anymore. It is called from whichever thread drops that last copy (usually an
+	 * OpenPose worker thread).
+	 */
+	class HostFrameLease
+	{
+	public:
+		typedef void (*ReleaseFunction)(void* userData);
+
+		HostFrameLease(const ReleaseFunction releaseFunction, void* const userData) :
+			mReleaseFunction{releaseFunction},
+			pUserData{userData}
+		{
+		}
+
+		~HostFrameLease()
+		{
+			if (mReleaseFunction != nullptr)
+				mReleaseFunction(pUserData);
+			if (spHostFrameTracker != nullptr)
+				spHostFrameTracker->release();
+		}
+
+		/**
+		 * It counts this lease in `hostFrameTracker` until it is released. It must be called at most once.
+		 */
+		void track(const std::shared_ptr<HostFrameTracker>& hostFrameTracker)
+		{
+			spHostFrameTracker = hostFrameTracker;
+			spHostFrameTracker->acquire();
+		}
+
+	private:
+		const ReleaseFunction mReleaseFunction;
+		void* const pUserData;
+		std::shared_ptr<HostFrameTracker> spHostFrameTracker;
+
+		DELETE_COPY(HostFrameLease);
+	};
+
+	/**
+	 * HostDatum: op::Datum plus the lease of the host memory that op::Datum::cvInputData wraps (if any).
+	 * The lease is empty for frames coming from an op::Producer or that were converted to an OpenPose-owned buffer.
+	 * HostDatum is meant to be moved: its copies still work (they are shallow, as op::Datum ones), but each one is
+	 * counted in CopyStatistics.
+	 */
+	struct HostDatum : public op::Datum
+	{
+		HostDatum() = default;
+
+		HostDatum(const HostDatum& hostDatum) :
+			op::Datum(hostDatum),
+			spHostFrameLease{hostDatum.spHostFrameLease},
+			pHostFrameData{hostDatum.pHostFrameData},
+			inputTimestampNs{hostDatum.inputTimestampNs},
+			postProcessingTimestampNs{hostDatum.postProcessingTimestampNs}
+		{
+			CopyStatistics::getInstance().addDatumCopy();
+		}
+
+		HostDatum& operator=(const HostDatum& hostDatum)
+		{
+			op::Datum::operator=(hostDatum);
+			spHostFrameLease = hostDatum.spHostFrameLease;
+			pHostFrameData = hostDatum.pHostFrameData;
+			inputTimestampNs = hostDatum.inputTimestampNs;
+			postProcessingTimestampNs = hostDatum.postProcessingTimestampNs;
+			CopyStatistics::getInstance().addDatumCopy();
+			return *this;
+		}
+
+		HostDatum(HostDatum&& hostDatum) = default;
+
+		HostDatum& operator=(HostDatum&& hostDatum) = default;
+
+
+		std::shared_ptr<HostFrameLease> spHostFrameLease;
+		// Host memory wrapped by cvInputData when the frame was pushed (null if it was converted), to detect any worker
+		// replacing it with a copy
+		const unsigned char* pHostFrameData = nullptr;
+		// getTimestampNs() at which the host pushed the frame, 0 for frames coming from an op::Producer
+		long long inputTimestampNs = 0;
+		// getTimestampNs() at which WHostFrameRelease processed the frame
+		long long postProcessingTimestampNs = 0;
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_HOST_DATUM_HPP
@@ -0,0 +1,132 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_INT8_CALIBRATION_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_INT8_CALIBRATION_HPP
+
+// C++ std library dependencies
+#include <fstream>
+#include <string>
+#include <vector>
+// OpenCV dependencies (cv::dnn::Net::quantize exists since OpenCV 4.6)
+#include <opencv2/core/core.hpp>
+#include <opencv2/core/version.hpp>
+#if CV_MAJOR_VERSION > 4 || (CV_MAJOR_VERSION == 4 && CV_MINOR_VERSION >= 6)
+	#define OPENPOSE_DLL_EXPORT_OPENCV_DNN_INT8
+#endif
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "../dllExportFile.hpp"
+#include "fusedCvMatToOpInput.hpp"
+#include "scalePlanCache.hpp"
+
+namespace dllExport
+{
+	/**
+	 * Int8Calibration: content of the file written by openPoseCalibrateInt8 and read by the int8 PoseEngineOpenCv.
+	 * It is a calibration image list, not a quantized model: OpenCV can neither serialize a quantized network nor take
+	 * precomputed activation ranges, so cv::dnn::Net::quantize recomputes them from these images (which must therefore
+	 * still exist) every time the engine is loaded, at the cost of one fp32 forward pass per image. The accuracy report
+	 * is only written for inspection.
+	 */
+	struct Int8Calibration
+	{
+		op::PoseModel poseModel;
+		op::Point<int> netInputSize;
+		std::vector<std::string> imagePaths;
+		OpenPoseInt8Report report;
+	};
+
+	inline void writeInt8Calibration(const std::string& path, const Int8Calibration& int8Calibration)
+	{
+		try
+		{
+			cv::FileStorage fileStorage{path, cv::FileStorage::WRITE};
+			if (!fileStorage.isOpened())
+				op::error("Int8 calibration file " + path + " could not be written.", __LINE__, __FUNCTION__, __FILE__);
+			fileStorage << "poseModel" << (int)int8Calibration.poseModel;
+			fileStorage << "netInputWidth" << int8Calibration.netInputSize.x;
+			fileStorage << "netInputHeight" << int8Calibration.netInputSize.y;
+			fileStorage << "imagePaths" << int8Calibration.imagePaths;
+			const auto& report = int8Calibration.report;
+			fileStorage << "report" << "{";
+			fileStorage << "numberImages" << report.numberImages;
+			fileStorage << "fp32MsPerImage" << report.fp32MsPerImage;
+			fileStorage << "int8MsPerImage" << report.int8MsPerImage;
+			fileStorage << "fp32People" << report.fp32People;
+			fileStorage << "int8People" << report.int8People;
+			fileStorage << "keypointRecall" << report.keypointRecall;
+			fileStorage << "meanKeypointErrorPixels" << report.meanKeypointErrorPixels;
+			fileStorage << "}";
+		}
+		catch (const std::exception& e)
+		{
+			op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+		}
+	}
+
+	/**
+	 * It only reads what the int8 engine needs (pose model, net input size and images), checking that the images exist.
+	 */
+	inline Int8Calibration readInt8Calibration(const std::string& path)
+	{
+		try
+		{
+			cv::FileStorage fileStorage{path, cv::FileStorage::READ};
+			if (!fileStorage.isOpened())
+				op::error("Int8 calibration file " + path + " could not be read.", __LINE__, __FUNCTION__, __FILE__);
+			Int8Calibration int8Calibration{};
+			int poseModel;
+			fileStorage["poseModel"] >> poseModel;
+			int8Calibration.poseModel = (op::PoseModel)poseModel;
+			fileStorage["netInputWidth"] >> int8Calibration.netInputSize.x;
+			fileStorage["netInputHeight"] >> int8Calibration.netInputSize.y;
+			fileStorage["imagePaths"] >> int8Calibration.imagePaths;
+			if (int8Calibration.imagePaths.empty())
+				op::error("Int8 calibration file " + path + " has no calibration images.",
+					__LINE__, __FUNCTION__, __FILE__);
+			for (const auto& imagePath : int8Calibration.imagePaths)
+				if (!std::ifstream{imagePath}.good())
+					op::error("Calibration image " + imagePath + " (listed in " + path + ") does not exist. Run"
+						" openPoseCalibrateInt8 again.", __LINE__, __FUNCTION__, __FILE__);
+			return int8Calibration;
+		}
+		catch (const std::exception& e)
+		{
+			op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			return Int8Calibration{};
+		}
+	}
+
+	/**
+	 * Single-scale network inputs of the calibration images, {1, 3, height, width} each, built as BatchExtractor builds
+	 * them (ScalePlanCache and FusedCvMatToOpInput), so the calibration sees the same input distribution as inference.
+	 */
+	inline std::vector<op::Array<float>> createCalibrationInputs(const Int8Calibration& int8Calibration)
+	{
+		try
+		{
+			ScalePlanCache scalePlanCache{int8Calibration.netInputSize, op::Point<int>{-1, -1}, 1, 0.};
+			FusedCvMatToOpInput fusedCvMatToOpInput;
+			std::vector<op::Array<float>> calibrationInputs;
+			calibrationInputs.reserve(int8Calibration.imagePaths.size());
+			for (const auto& imagePath : int8Calibration.imagePaths)
+			{
+				const auto image = op::loadImage(imagePath, cv::IMREAD_COLOR);
+				if (image.empty())
+					op::error("Calibration image " + imagePath + " could not be read.",
+						__LINE__, __FUNCTION__, __FILE__);
+				const auto& scalePlan = scalePlanCache.extract(op::Point<int>{image.cols, image.rows});
+				// A new array per image (the returning createArray never reuses one)
+				calibrationInputs.emplace_back(fusedCvMatToOpInput.createArray(image, scalePlan.scaleInputToNetInputs,
+					scalePlan.netInputSizes));
+			}
+			return calibrationInputs;
+		}
+		catch (const std::exception& e)
+		{
+			op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			return {};
+		}
+	}
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_INT8_CALIBRATION_HPP
@@ -0,0 +1,157 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_INT8_CALIBRATOR_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_INT8_CALIBRATOR_HPP
+
+// C++ std library dependencies
+#include <algorithm> // std::max
+#include <cmath> // std::hypot
+#include <string>
+#include <vector>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "../dllExportFile.hpp"
+#include "fusedCvMatToOpInput.hpp"
+#include "int8Calibration.hpp"
+#include "poseEngineOpenCv.hpp"
+#include "scalePlanCache.hpp"
+#include "timestamp.hpp"
+
+namespace dllExport
+{
+	/**
+	 * It adds the keypoints of `referenceKeypoints` above `threshold` to `referenceCount`, and those also found in
+	 * `keypoints` to `matchedCount`, with their distance added to `errorSum`. Each reference person is compared with
+	 * the person that shares the most keypoints with it (the closest one on ties), since the people order may differ.
+	 */
+	inline void compareKeypoints(int& referenceCount, int& matchedCount, double& errorSum,
+		const op::Array<float>& referenceKeypoints, const op::Array<float>& keypoints, const float threshold)
+	{
+		if (referenceKeypoints.empty())
+			return;
+		const auto numberBodyParts = referenceKeypoints.getSize(1);
+		const auto numberPeople = (keypoints.empty() ? 0 : keypoints.getSize(0));
+		for (auto referencePerson = 0 ; referencePerson < referenceKeypoints.getSize(0) ; referencePerson++)
+		{
+			const auto* referencePtr = referenceKeypoints.getConstPtr() + 3 * referencePerson * numberBodyParts;
+			auto bestMatchedCount = 0;
+			auto bestErrorSum = 0.;
+			for (auto person = 0 ; person < numberPeople ; person++)
+			{
+				const auto* keypointPtr = keypoints.getConstPtr() + 3 * person * numberBodyParts;
+				auto personMatchedCount = 0;
+				auto personErrorSum = 0.;
+				for (auto part = 0 ; part < numberBodyParts ; part++)
+				{
+					if (referencePtr[3 * part + 2] > threshold && keypointPtr[3 * part + 2] > threshold)
+					{
+						personMatchedCount++;
+						personErrorSum += std::hypot(keypointPtr[3 * part] - referencePtr[3 * part],
+							keypointPtr[3 * part + 1] - referencePtr[3 * part + 1]);
+					}
+				}
+				if (personMatchedCount > bestMatchedCount
+					|| (personMatchedCount == bestMatchedCount && personErrorSum < bestErrorSum))
+				{
+					bestMatchedCount = personMatchedCount;
+					bestErrorSum = personErrorSum;
+				}
+			}
+			for (auto part = 0 ; part < numberBodyParts ; part++)
+				if (referencePtr[3 * part + 2] > threshold)
+					referenceCount++;
+			matchedCount += bestMatchedCount;
+			errorSum += bestErrorSum;
+		}
+	}
+
+	/**
+	 * Body of openPoseCalibrateInt8: it writes the Int8Calibration (image list) of the images of `imageDirectory` and
+	 * reports the int8 engine against the fp32 one on those same images (single scale, keypoints in input resolution).
+	 */
+	inline OpenPoseInt8Report calibrateInt8(const op::PoseModel poseModel, const std::string& modelFolder,
+		const op::Point<int>& netInputSize, const std::string& imageDirectory, const std::string& int8CalibrationPath,
+		const float threshold)
+	{
+		try
+		{
+			Int8Calibration int8Calibration{};
+			#ifdef OPENPOSE_DLL_EXPORT_OPENCV_DNN_INT8
+				int8Calibration.poseModel = poseModel;
+				int8Calibration.netInputSize = netInputSize;
+				// Same extensions as op::ImageDirectoryReader
+				int8Calibration.imagePaths = op::getFilesOnDirectory(imageDirectory, std::vector<std::string>{
+					"bmp", "dib", "pbm", "pgm", "ppm", "sr", "ras", "jpg", "jpeg", "png"});
+				if (int8Calibration.imagePaths.empty())
+					op::error("No calibration images in " + imageDirectory + ".", __LINE__, __FUNCTION__, __FILE__);
+				// Written before the int8 engine is created, since it is calibrated with this file
+				writeInt8Calibration(int8CalibrationPath, int8Calibration);
+
+				// Accuracy and speed of the int8 engine against the fp32 one
+				PoseEngineOpenCv fp32PoseEngine{poseModel, modelFolder};
+				PoseEngineOpenCv int8PoseEngine{poseModel, modelFolder, int8CalibrationPath};
+				fp32PoseEngine.initializationOnThread();
+				int8PoseEngine.initializationOnThread();
+				ScalePlanCache scalePlanCache{netInputSize, op::Point<int>{-1, -1}, 1, 0.};
+				FusedCvMatToOpInput fusedCvMatToOpInput;
+				auto& report = int8Calibration.report;
+				auto fp32Ns = 0ll;
+				auto int8Ns = 0ll;
+				auto referenceCount = 0;
+				auto matchedCount = 0;
+				auto errorSum = 0.;
+				// The first image is processed twice, so the first (allocating) pass of each network is not timed
+				for (auto index = -1 ; index < (int)int8Calibration.imagePaths.size() ; index++)
+				{
+					const auto image = op::loadImage(int8Calibration.imagePaths.at(std::max(index, 0)),
+						cv::IMREAD_COLOR);
+					const op::Point<int> imageSize{image.cols, image.rows};
+					const auto& scalePlan = scalePlanCache.extract(imageSize);
+					const auto inputNetData = fusedCvMatToOpInput.createArray(image, scalePlan.scaleInputToNetInputs,
+						scalePlan.netInputSizes);
+					const auto fp32BeginNs = getTimestampNs();
+					fp32PoseEngine.forwardPass(inputNetData, imageSize, scalePlan.scaleInputToNetInputs);
+					const auto int8BeginNs = getTimestampNs();
+					int8PoseEngine.forwardPass(inputNetData, imageSize, scalePlan.scaleInputToNetInputs);
+					const auto int8EndNs = getTimestampNs();
+					if (index < 0)
+						continue;
+					fp32Ns += int8BeginNs - fp32BeginNs;
+					int8Ns += int8EndNs - int8BeginNs;
+					const auto fp32Keypoints = fp32PoseEngine.getPoseKeypoints();
+					const auto int8Keypoints = int8PoseEngine.getPoseKeypoints();
+					report.fp32People += (fp32Keypoints.empty() ? 0 : fp32Keypoints.getSize(0));
+					report.int8People += (int8Keypoints.empty() ? 0 : int8Keypoints.getSize(0));
+					compareKeypoints(referenceCount, matchedCount, errorSum, fp32Keypoints, int8Keypoints, threshold);
+				}
+				report.numberImages = (int)int8Calibration.imagePaths.size();
+				report.fp32MsPerImage = 1e-6 * fp32Ns / report.numberImages;
+				report.int8MsPerImage = 1e-6 * int8Ns / report.numberImages;
+				report.keypointRecall = (referenceCount > 0 ? matchedCount / (double)referenceCount : 1.);
+				report.meanKeypointErrorPixels = (matchedCount > 0 ? errorSum / matchedCount : 0.);
+				writeInt8Calibration(int8CalibrationPath, int8Calibration);
+				op::log("Int8 calibration written to " + int8CalibrationPath + ": " + std::to_string(report.numberImages)
+					+ " images, " + std::to_string(report.fp32MsPerImage) + " ms (fp32) vs "
+					+ std::to_string(report.int8MsPerImage) + " ms (int8) per image, keypoint recall "
+					+ std::to_string(report.keypointRecall) + ", mean keypoint error "
+					+ std::to_string(report.meanKeypointErrorPixels) + " pixels.", op::Priority::High);
+			#else
+				(void)poseModel;
+				(void)modelFolder;
+				(void)netInputSize;
+				(void)imageDirectory;
+				(void)int8CalibrationPath;
+				(void)threshold;
+				op::error("Int8 calibration requires OpenCV 4.6 or later (cv::dnn::Net::quantize).",
+					__LINE__, __FUNCTION__, __FILE__);
+			#endif
+			return int8Calibration.report;
+		}
+		catch (const std::exception& e)
+		{
+			op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			return OpenPoseInt8Report{};
+		}
+	}
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_INT8_CALIBRATOR_HPP
@@ -0,0 +1,102 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_KEYPOINT_CALLBACK_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_KEYPOINT_CALLBACK_HPP
+
+// C++ std library dependencies
+#include <algorithm> // std::fill, std::max
+#include <cstring> // std::memcpy
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "../dllExportFile.hpp"
+#include "arrayView.hpp"
+#include "timestamp.hpp"
+
+namespace dllExport
+{
+	/**
+	 * KeypointCallback: host function called with the keypoints of each processed frame.
+	 * The OpenPoseKeypointFrame given to the host points to buffers owned by this class, which are only valid during the
+	 * call. They are reused from frame to frame (they only grow), so fire() does not allocate in the steady state. It
+	 * must always be called from the same thread.
+	 */
+	class KeypointCallback
+	{
+	public:
+		KeypointCallback(const OpenPoseKeypointCallback callback, void* const userData) :
+			mCallback{callback},
+			pUserData{userData}
+		{
+		}
+
+		void fire(const op::Datum& datum, const long long inputTimestampNs)
+		{
+			try
+			{
+				const auto numberPeople = std::max(std::max(getNumberPeople(datum.poseKeypoints),
+					getNumberPeople(datum.faceKeypoints)), std::max(getNumberPeople(datum.handKeypoints[0]),
+					getNumberPeople(datum.handKeypoints[1])));
+				OpenPoseKeypointFrame frame;
+				frame.frameId = datum.id;
+				frame.inputTimestampNs = inputTimestampNs;
+				frame.numberPeople = numberPeople;
+				frame.numberBodyParts = getNumberParts(datum.poseKeypoints);
+				frame.numberFaceParts = getNumberParts(datum.faceKeypoints);
+				frame.numberHandParts = std::max(getNumberParts(datum.handKeypoints[0]),
+					getNumberParts(datum.handKeypoints[1]));
+				frame.maxPeople = numberPeople;
+				// Same layout as openPoseSessionPollKeypoints, with maxPeople = numberPeople
+				const auto handSize = numberPeople * frame.numberHandParts * 3;
+				frame.poseKeypoints = copyPeople(mPoseKeypoints, datum.poseKeypoints, numberPeople * frame.numberBodyParts * 3);
+				frame.faceKeypoints = copyPeople(mFaceKeypoints, datum.faceKeypoints, numberPeople * frame.numberFaceParts * 3);
+				frame.handKeypoints = copyPeople(mHandKeypoints, datum.handKeypoints[0], 2 * handSize);
+				if (frame.handKeypoints != nullptr)
+					copyRows(frame.handKeypoints + handSize, datum.handKeypoints[1]);
+				frame.timestampNs = getTimestampNs();
+				mCallback(&frame, pUserData);
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+	private:
+		const OpenPoseKeypointCallback mCallback;
+		void* const pUserData;
+		AlignedBuffer<float> mPoseKeypoints;
+		AlignedBuffer<float> mFaceKeypoints;
+		AlignedBuffer<float> mHandKeypoints;
+
+		static int getNumberPeople(const op::Array<float>& keypoints)
+		{
+			return (keypoints.empty() ? 0 : keypoints.getSize(0));
+		}
+
+		static int getNumberParts(const op::Array<float>& keypoints)
+		{
+			return (keypoints.empty() ? 0 : keypoints.getSize(1));
+		}
+
+		// It returns the (zero-filled) buffer of `size` floats, starting with `keypoints`, or nullptr if `size` is 0
+		static float* copyPeople(AlignedBuffer<float>& buffer, const op::Array<float>& keypoints, const int size)
+		{
+			if (size <= 0)
+				return nullptr;
+			if ((int)buffer.size() < size)
+				buffer.resize(size);
+			std::fill(buffer.data(), buffer.data() + size, 0.f);
+			copyRows(buffer.data(), keypoints);
+			return buffer.data();
+		}
+
+		static void copyRows(float* target, const op::Array<float>& keypoints)
+		{
+			if (!keypoints.empty())
+				std::memcpy(target, keypoints.getConstPtr(), keypoints.getVolume() * sizeof(float));
+		}
+
+		DELETE_COPY(KeypointCallback);
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_KEYPOINT_CALLBACK_HPP
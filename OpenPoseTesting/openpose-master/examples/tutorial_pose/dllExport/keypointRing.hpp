@@ -0,0 +1,220 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_KEYPOINT_RING_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_KEYPOINT_RING_HPP
+
+// C++ std library dependencies
+#include <algorithm> // std::fill, std::min, std::max
+#include <atomic>
+#include <cstring> // std::memcpy
+#include <memory>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "../dllExportFile.hpp"
+#include "arrayView.hpp"
+#include "timestamp.hpp"
+
+namespace dllExport
+{
+	/**
+	 * KeypointRing: bounded single-producer/single-consumer ring of keypoint snapshots.
+	 * The producer (the output worker) never waits for the consumer: it always writes the next slot and overwrites the
+	 * oldest entry. The consumer only reads the latest entry. Each slot is guarded by a sequence counter (seqlock), so
+	 * the consumer detects and retries the rare read that overlaps a write of the same slot. The consumer reads the slot
+	 * into its own scratch slot and only copies it to the caller once validated, so a torn read never reaches the caller
+	 * buffers. Neither side takes a lock, and all the slot memory is allocated in the constructor.
+	 */
+	class KeypointRing
+	{
+	public:
+		KeypointRing(const int numberBodyParts, const int numberFaceParts, const int numberHandParts, const int maxPeople,
+			const unsigned int capacity = 8u) :
+			mNumberBodyParts{numberBodyParts},
+			mNumberFaceParts{numberFaceParts},
+			mNumberHandParts{numberHandParts},
+			mMaxPeople{maxPeople},
+			mCapacity{capacity},
+			upSlots{new Slot[capacity]},
+			mNumberWritten{0ull}
+		{
+			try
+			{
+				if (numberBodyParts < 0 || numberFaceParts < 0 || numberHandParts < 0 || maxPeople < 1 || capacity < 2)
+					op::error("Wrong KeypointRing size.", __LINE__, __FUNCTION__, __FILE__);
+				for (auto i = 0u; i < mCapacity; i++)
+				{
+					upSlots[i].sequence.store(0ull, std::memory_order_relaxed);
+					allocateSlot(upSlots[i]);
+				}
+				allocateSlot(mScratchSlot);
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+		/**
+		 * Producer side. It must be called from a single thread.
+		 */
+		void push(const op::Datum& datum, const long long inputTimestampNs = 0)
+		{
+			try
+			{
+				const auto index = mNumberWritten.load(std::memory_order_relaxed);
+				auto& slot = upSlots[index % mCapacity];
+				// Odd sequence: slot being written
+				slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_release);
+				slot.frameId = datum.id;
+				slot.timestampNs = getTimestampNs();
+				slot.inputTimestampNs = inputTimestampNs;
+				const auto posePeople = copyPeople(slot.poseKeypoints.data(), datum.poseKeypoints, mNumberBodyParts);
+				const auto facePeople = copyPeople(slot.faceKeypoints.data(), datum.faceKeypoints, mNumberFaceParts);
+				const auto handOffset = mMaxPeople * mNumberHandParts * 3;
+				const auto leftPeople = copyPeople(slot.handKeypoints.data(), datum.handKeypoints[0], mNumberHandParts);
+				const auto rightPeople = copyPeople(slot.handKeypoints.data() + handOffset, datum.handKeypoints[1],
+					mNumberHandParts);
+				slot.numberPeople = std::max(std::max(posePeople, facePeople), std::max(leftPeople, rightPeople));
+				// The arrays with fewer people (e.g. no body pose) would otherwise expose the rows of an older entry
+				zeroPeople(slot.poseKeypoints.data(), posePeople, slot.numberPeople, mNumberBodyParts);
+				zeroPeople(slot.faceKeypoints.data(), facePeople, slot.numberPeople, mNumberFaceParts);
+				zeroPeople(slot.handKeypoints.data(), leftPeople, slot.numberPeople, mNumberHandParts);
+				zeroPeople(slot.handKeypoints.data() + handOffset, rightPeople, slot.numberPeople, mNumberHandParts);
+				slot.hasFace = !datum.faceKeypoints.empty();
+				slot.hasHands = !datum.handKeypoints[0].empty() || !datum.handKeypoints[1].empty();
+				// Even sequence: entry `index` complete
+				slot.sequence.store(2 * index + 2, std::memory_order_release);
+				mNumberWritten.store(index + 1, std::memory_order_release);
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+		/**
+		 * Consumer side. It copies the latest entry into the caller buffers (null arrays are skipped), without locking
+		 * nor allocating. It must be called from a single thread at a time.
+		 * @return Whether an entry was copied. False if nothing was written yet (or, very unlikely, if the producer kept
+		 * overwriting the slot being read) or if the latest entry is older than `minimumFrameId`, in which case `frame`
+		 * and its buffers are left untouched.
+		 */
+		bool pollLatest(OpenPoseKeypointFrame& frame, const unsigned long long minimumFrameId = 0ull) const
+		{
+			const auto maxPeople = std::max(frame.maxPeople, 0);
+			for (auto attempt = 0; attempt < 4; attempt++)
+			{
+				const auto numberWritten = mNumberWritten.load(std::memory_order_acquire);
+				if (numberWritten == 0ull)
+					return false;
+				const auto index = numberWritten - 1;
+				const auto& slot = upSlots[index % mCapacity];
+				const auto sequence = slot.sequence.load(std::memory_order_acquire);
+				if (sequence != 2 * index + 2)
+					continue;
+				// Into the scratch slot first (only the people the caller can take)
+				mScratchSlot.frameId = slot.frameId;
+				mScratchSlot.timestampNs = slot.timestampNs;
+				mScratchSlot.inputTimestampNs = slot.inputTimestampNs;
+				mScratchSlot.numberPeople = std::min(std::min(slot.numberPeople, maxPeople), mMaxPeople);
+				mScratchSlot.hasFace = slot.hasFace;
+				mScratchSlot.hasHands = slot.hasHands;
+				const auto numberPeople = std::max(mScratchSlot.numberPeople, 0);
+				const auto poseFloats = numberPeople * mNumberBodyParts * 3;
+				const auto faceFloats = numberPeople * mNumberFaceParts * 3;
+				const auto handFloats = numberPeople * mNumberHandParts * 3;
+				const auto handOffset = mMaxPeople * mNumberHandParts * 3;
+				copyRows(mScratchSlot.poseKeypoints.data(), slot.poseKeypoints.data(), poseFloats);
+				copyRows(mScratchSlot.faceKeypoints.data(), slot.faceKeypoints.data(), faceFloats);
+				copyRows(mScratchSlot.handKeypoints.data(), slot.handKeypoints.data(), handFloats);
+				copyRows(mScratchSlot.handKeypoints.data() + handOffset, slot.handKeypoints.data() + handOffset,
+					handFloats);
+				// If the producer started rewriting this slot meanwhile, the copy might be torn: try again
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+					continue;
+				// E.g. a frame of the previous owner of a reused session (see Session::resetOwner)
+				if (mScratchSlot.frameId < minimumFrameId)
+					return false;
+				// Validated: only now the caller buffers are written
+				frame.frameId = mScratchSlot.frameId;
+				frame.timestampNs = mScratchSlot.timestampNs;
+				frame.inputTimestampNs = mScratchSlot.inputTimestampNs;
+				frame.numberPeople = numberPeople;
+				frame.numberBodyParts = mNumberBodyParts;
+				frame.numberFaceParts = (mScratchSlot.hasFace ? mNumberFaceParts : 0);
+				frame.numberHandParts = (mScratchSlot.hasHands ? mNumberHandParts : 0);
+				copyRows(frame.poseKeypoints, mScratchSlot.poseKeypoints.data(), poseFloats);
+				copyRows(frame.faceKeypoints, mScratchSlot.faceKeypoints.data(), faceFloats);
+				if (frame.handKeypoints != nullptr)
+				{
+					const auto targetOffset = frame.maxPeople * mNumberHandParts * 3;
+					copyRows(frame.handKeypoints, mScratchSlot.handKeypoints.data(), handFloats);
+					copyRows(frame.handKeypoints + targetOffset, mScratchSlot.handKeypoints.data() + handOffset,
+						handFloats);
+				}
+				return true;
+			}
+			return false;
+		}
+
+	private:
+		struct Slot
+		{
+			std::atomic<unsigned long long> sequence;
+			unsigned long long frameId;
+			long long timestampNs;
+			long long inputTimestampNs;
+			int numberPeople;
+			bool hasFace;
+			bool hasHands;
+			AlignedBuffer<float> poseKeypoints;
+			AlignedBuffer<float> faceKeypoints;
+			AlignedBuffer<float> handKeypoints;
+		};
+
+		const int mNumberBodyParts;
+		const int mNumberFaceParts;
+		const int mNumberHandParts;
+		const int mMaxPeople;
+		const unsigned int mCapacity;
+		const std::unique_ptr<Slot[]> upSlots;
+		std::atomic<unsigned long long> mNumberWritten;
+		// Consumer only
+		mutable Slot mScratchSlot;
+
+		void allocateSlot(Slot& slot) const
+		{
+			slot.poseKeypoints.resize(mMaxPeople * mNumberBodyParts * 3);
+			slot.faceKeypoints.resize(mMaxPeople * mNumberFaceParts * 3);
+			slot.handKeypoints.resize(2 * mMaxPeople * mNumberHandParts * 3);
+		}
+
+		// It returns the number of people copied, at most mMaxPeople
+		int copyPeople(float* target, const op::Array<float>& keypoints, const int numberParts) const
+		{
+			if (keypoints.empty() || numberParts == 0 || keypoints.getSize(1) != numberParts)
+				return 0;
+			const auto numberPeople = std::min(keypoints.getSize(0), mMaxPeople);
+			std::memcpy(target, keypoints.getConstPtr(), numberPeople * numberParts * 3 * sizeof(float));
+			return numberPeople;
+		}
+
+		// Rows [firstPerson, endPerson) set to 0, i.e. keypoints not found
+		static void zeroPeople(float* target, const int firstPerson, const int endPerson, const int numberParts)
+		{
+			if (endPerson > firstPerson)
+				std::fill(target + firstPerson * numberParts * 3, target + endPerson * numberParts * 3, 0.f);
+		}
+
+		static void copyRows(float* target, const float* const source, const int numberFloats)
+		{
+			if (target != nullptr && numberFloats > 0)
+				std::memcpy(target, source, numberFloats * sizeof(float));
+		}
+
+		DELETE_COPY(KeypointRing);
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_KEYPOINT_RING_HPP
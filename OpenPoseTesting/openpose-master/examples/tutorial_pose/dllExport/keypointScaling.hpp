@@ -0,0 +1,173 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_KEYPOINT_SCALING_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_KEYPOINT_SCALING_HPP
+
+// C++ std library dependencies
+#include <algorithm> // std::max
+// SIMD dependencies (selected at compile time, e.g. -mavx2 or /arch:AVX2)
+#if defined(__AVX2__) || defined(__AVX__)
+	#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define OPENPOSE_DLL_EXPORT_KEYPOINT_SSE2
+#endif
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+
+namespace dllExport
+{
+	/**
+	 * Affine transform of the keypoint coordinates: x' = x * scaleX + offsetX, y' = y * scaleY + offsetY. The scores
+	 * are left untouched.
+	 */
+	struct KeypointTransform
+	{
+		float scaleX;
+		float scaleY;
+		float offsetX;
+		float offsetY;
+	};
+
+	/**
+	 * It returns the transform to `keypointScale` coordinates for a frame of `inputSize` pixels, from output resolution
+	 * coordinates (the ones of op::Datum after an op::KeypointScaler set to ScaleMode::OutputResolution) or, if
+	 * `fromInputResolution`, from input resolution coordinates (the ones of op::PoseExtractor::getPoseKeypoints).
+	 * `scaleNetToOutput` is the one of the extractors, i.e. from net (heat map) to input resolution.
+	 */
+	inline KeypointTransform getKeypointScaleTransform(const op::ScaleMode keypointScale, const double scaleInputToOutput,
+		const double scaleNetToOutput, const op::Point<int>& inputSize, const bool fromInputResolution = false)
+	{
+		// Output resolution -> keypointScale, computed in double so the input resolution round trip is exact
+		auto scaleX = 1.;
+		auto scaleY = 1.;
+		auto offset = 0.f;
+		if (keypointScale == op::ScaleMode::InputResolution)
+		{
+			scaleX = 1. / scaleInputToOutput;
+			scaleY = scaleX;
+		}
+		else if (keypointScale == op::ScaleMode::NetOutputResolution)
+		{
+			scaleX = 1. / (scaleInputToOutput * scaleNetToOutput);
+			scaleY = scaleX;
+		}
+		else if (keypointScale == op::ScaleMode::ZeroToOne || keypointScale == op::ScaleMode::PlusMinusOne)
+		{
+			// [0, size - 1] input pixels -> [0, 1] or [-1, 1]
+			const auto range = (keypointScale == op::ScaleMode::ZeroToOne ? 1. : 2.);
+			offset = (keypointScale == op::ScaleMode::ZeroToOne ? 0.f : -1.f);
+			scaleX = range / (std::max(inputSize.x - 1, 1) * scaleInputToOutput);
+			scaleY = range / (std::max(inputSize.y - 1, 1) * scaleInputToOutput);
+		}
+		// Else ScaleMode::OutputResolution
+		const auto sourceToOutput = (fromInputResolution ? scaleInputToOutput : 1.);
+		return KeypointTransform{(float)(scaleX * sourceToOutput), (float)(scaleY * sourceToOutput), offset, offset};
+	}
+
+	/**
+	 * It applies `transform` to `numberKeypoints` (x, y, score) triplets from `source` into `target` (which can be
+	 * `source` itself). The triplets are processed in blocks of 8 (AVX) or 4 (SSE2) with per-lane multiplier and offset
+	 * vectors whose score lanes are (1, 0), so the scores are copied exactly.
+	 */
+	inline void transformKeypoints(float* target, const float* source, const int numberKeypoints,
+		const KeypointTransform& transform)
+	{
+		auto i = 0;
+		const auto numberFloats = 3 * numberKeypoints;
+		#if defined(__AVX2__) || defined(__AVX__)
+			// 8 triplets = 3 vectors, lane k of vector v holds component (8v + k) % 3
+			const __m256 scales[3]{
+				_mm256_setr_ps(transform.scaleX, transform.scaleY, 1.f, transform.scaleX, transform.scaleY, 1.f,
+					transform.scaleX, transform.scaleY),
+				_mm256_setr_ps(1.f, transform.scaleX, transform.scaleY, 1.f, transform.scaleX, transform.scaleY, 1.f,
+					transform.scaleX),
+				_mm256_setr_ps(transform.scaleY, 1.f, transform.scaleX, transform.scaleY, 1.f, transform.scaleX,
+					transform.scaleY, 1.f)};
+			const __m256 offsets[3]{
+				_mm256_setr_ps(transform.offsetX, transform.offsetY, 0.f, transform.offsetX, transform.offsetY, 0.f,
+					transform.offsetX, transform.offsetY),
+				_mm256_setr_ps(0.f, transform.offsetX, transform.offsetY, 0.f, transform.offsetX, transform.offsetY, 0.f,
+					transform.offsetX),
+				_mm256_setr_ps(transform.offsetY, 0.f, transform.offsetX, transform.offsetY, 0.f, transform.offsetX,
+					transform.offsetY, 0.f)};
+			for ( ; i + 24 <= numberFloats ; i += 24)
+				for (auto v = 0 ; v < 3 ; v++)
+					_mm256_storeu_ps(target + i + 8 * v, _mm256_add_ps(
+						_mm256_mul_ps(_mm256_loadu_ps(source + i + 8 * v), scales[v]), offsets[v]));
+		#elif defined(OPENPOSE_DLL_EXPORT_KEYPOINT_SSE2)
+			// 4 triplets = 3 vectors, lane k of vector v holds component (4v + k) % 3
+			const __m128 scales[3]{
+				_mm_setr_ps(transform.scaleX, transform.scaleY, 1.f, transform.scaleX),
+				_mm_setr_ps(transform.scaleY, 1.f, transform.scaleX, transform.scaleY),
+				_mm_setr_ps(1.f, transform.scaleX, transform.scaleY, 1.f)};
+			const __m128 offsets[3]{
+				_mm_setr_ps(transform.offsetX, transform.offsetY, 0.f, transform.offsetX),
+				_mm_setr_ps(transform.offsetY, 0.f, transform.offsetX, transform.offsetY),
+				_mm_setr_ps(0.f, transform.offsetX, transform.offsetY, 0.f)};
+			for ( ; i + 12 <= numberFloats ; i += 12)
+				for (auto v = 0 ; v < 3 ; v++)
+					_mm_storeu_ps(target + i + 4 * v, _mm_add_ps(
+						_mm_mul_ps(_mm_loadu_ps(source + i + 4 * v), scales[v]), offsets[v]));
+		#endif
+		for ( ; i < numberFloats ; i += 3)
+		{
+			target[i] = source[i] * transform.scaleX + transform.offsetX;
+			target[i+1] = source[i+1] * transform.scaleY + transform.offsetY;
+			target[i+2] = source[i+2];
+		}
+	}
+
+	/**
+	 * KeypointScaling: vectorized, in-place replacement of op::KeypointScaler for a whole op::Datum. It scales the pose,
+	 * face and both hand keypoint arrays with a single transform (see transformKeypoints), from input resolution (the
+	 * one of the extractors, i.e. of op::Wrapper with ScaleMode::InputResolution) into `keypointScale`.
+	 */
+	class KeypointScaling
+	{
+	public:
+		explicit KeypointScaling(const op::ScaleMode keypointScale) :
+			mKeypointScale{keypointScale}
+		{
+		}
+
+		bool isIdentity() const
+		{
+			return mKeypointScale == op::ScaleMode::InputResolution;
+		}
+
+		/**
+		 * `inputSize` is the size of the frame the keypoints come from (i.e. of datum.cvInputData).
+		 */
+		void scale(op::Datum& datum, const op::Point<int>& inputSize) const
+		{
+			try
+			{
+				if (isIdentity())
+					return;
+				const auto transform = getKeypointScaleTransform(mKeypointScale, datum.scaleInputToOutput,
+					datum.scaleNetToOutput, inputSize, true);
+				scaleArray(datum.poseKeypoints, transform);
+				scaleArray(datum.faceKeypoints, transform);
+				scaleArray(datum.handKeypoints[0], transform);
+				scaleArray(datum.handKeypoints[1], transform);
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+	private:
+		const op::ScaleMode mKeypointScale;
+
+		static void scaleArray(op::Array<float>& keypoints, const KeypointTransform& transform)
+		{
+			if (!keypoints.empty())
+				transformKeypoints(keypoints.getPtr(), keypoints.getConstPtr(), (int)keypoints.getVolume() / 3,
+					transform);
+		}
+
+		DELETE_COPY(KeypointScaling);
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_KEYPOINT_SCALING_HPP
@@ -0,0 +1,115 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_POSE_CPU_POST_PROCESSING_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_POSE_CPU_POST_PROCESSING_HPP
+
+// C++ std library dependencies
+#include <array>
+#include <vector>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "timestamp.hpp"
+
+namespace dllExport
+{
+	/**
+	 * PoseCpuPostProcessing: everything op::PoseExtractorCaffe does after the network, on the CPU: resize and merge of
+	 * the heat maps, NMS and body part connection, with the default parameters of `poseModel`. It is shared by the
+	 * PoseEngine implementations that only run the network themselves.
+	 * Not thread-safe: its arrays are reused from frame to frame.
+	 */
+	class PoseCpuPostProcessing
+	{
+	public:
+		explicit PoseCpuPostProcessing(const op::PoseModel poseModel) :
+			mPoseModel{poseModel},
+			mNumberBodyParts{(int)op::POSE_NUMBER_BODY_PARTS.at((int)poseModel)},
+			mScaleNetToOutput{1.},
+			mResizeAndNmsNs{0ll},
+			mConnectionNs{0ll}
+		{
+		}
+
+		/**
+		 * @param netOutputPtr Network output, {number scales, channels, height, width} (`netOutputSize`).
+		 * @param netInputSize Resolution of the heat maps after the resize (the net input one, i.e. scale 0).
+		 */
+		void process(const float* const netOutputPtr, const std::array<int, 4>& netOutputSize,
+			const op::Point<int>& netInputSize, const std::vector<double>& scaleInputToNetInputs)
+		{
+			try
+			{
+				const auto beginNs = getTimestampNs();
+				// Heat maps and PAFs upsampled to the net input resolution and averaged over the scales
+				const std::array<int, 4> heatMapSize{1, netOutputSize[1], netInputSize.y, netInputSize.x};
+				resizeArray(mHeatMaps, heatMapSize);
+				op::resizeAndMergeCpu(mHeatMaps.getPtr(), netOutputPtr, heatMapSize, netOutputSize,
+					std::vector<float>(scaleInputToNetInputs.begin(), scaleInputToNetInputs.end()));
+				// Peaks of each body part (without background)
+				const std::array<int, 4> peaksSize{1, mNumberBodyParts, (int)op::POSE_MAX_PEAKS + 1, 3};
+				resizeArray(mPeaks, peaksSize);
+				op::nmsCpu(mPeaks.getPtr(), (int*)nullptr, mHeatMaps.getConstPtr(),
+					op::POSE_DEFAULT_NMS_THRESHOLD.at((int)mPoseModel), peaksSize, heatMapSize);
+				const auto nmsEndNs = getTimestampNs();
+				// Body part connection, scaled from net to input resolution (as op::PoseExtractorCaffe)
+				mScaleNetToOutput = 1. / scaleInputToNetInputs.at(0);
+				const auto poseModelIndex = (int)mPoseModel;
+				op::connectBodyPartsCpu(mPoseKeypoints, mHeatMaps.getConstPtr(), mPeaks.getConstPtr(), mPoseModel,
+					op::Point<int>{heatMapSize[3], heatMapSize[2]}, (int)op::POSE_MAX_PEAKS,
+					(int)op::POSE_DEFAULT_CONNECT_INTER_MIN_ABOVE_THRESHOLD.at(poseModelIndex),
+					op::POSE_DEFAULT_CONNECT_INTER_THRESHOLD.at(poseModelIndex),
+					(int)op::POSE_DEFAULT_CONNECT_MIN_SUBSET_CNT.at(poseModelIndex),
+					op::POSE_DEFAULT_CONNECT_MIN_SUBSET_SCORE.at(poseModelIndex), (float)mScaleNetToOutput);
+				mResizeAndNmsNs = nmsEndNs - beginNs;
+				mConnectionNs = getTimestampNs() - nmsEndNs;
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+		const op::Array<float>& getPoseKeypoints() const
+		{
+			return mPoseKeypoints;
+		}
+
+		double getScaleNetToOutput() const
+		{
+			return mScaleNetToOutput;
+		}
+
+		// Steps of the last process()
+		long long getResizeAndNmsNs() const
+		{
+			return mResizeAndNmsNs;
+		}
+
+		long long getConnectionNs() const
+		{
+			return mConnectionNs;
+		}
+
+	private:
+		const op::PoseModel mPoseModel;
+		const int mNumberBodyParts;
+		// Reused from frame to frame
+		op::Array<float> mHeatMaps;
+		op::Array<float> mPeaks;
+		op::Array<float> mPoseKeypoints;
+		double mScaleNetToOutput;
+		long long mResizeAndNmsNs;
+		long long mConnectionNs;
+
+		// op::Array::reset always allocates, so it is only called when the size changes
+		static void resizeArray(op::Array<float>& array, const std::array<int, 4>& size)
+		{
+			const std::vector<int> sizeVector(size.begin(), size.end());
+			if (array.getSize() != sizeVector)
+				array.reset(sizeVector);
+		}
+
+		DELETE_COPY(PoseCpuPostProcessing);
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_POSE_CPU_POST_PROCESSING_HPP
@@ -0,0 +1,53 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_POSE_ENGINE_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_POSE_ENGINE_HPP
+
+// C++ std library dependencies
+#include <vector>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "stageStatistics.hpp"
+
+namespace dllExport
+{
+	/**
+	 * PoseEngine: body pose inference (network, heat map resize and merge, NMS and body part connection) behind
+	 * BatchExtractor, i.e. the subset of op::PoseExtractor that it uses, so the inference backend can be replaced.
+	 * As op::PoseExtractor, the keypoints are in input resolution and getScaleNetToOutput() maps the net (heat map)
+	 * resolution to the input one.
+	 */
+	class PoseEngine
+	{
+	public:
+		virtual ~PoseEngine()
+		{
+		}
+
+		/**
+		 * It loads the network. It must be called from the thread that later calls forwardPass().
+		 */
+		virtual void initializationOnThread() = 0;
+
+		/**
+		 * @param inputNetData Output of op::CvMatToOpInput::createArray, i.e. {number scales, 3, height, width}.
+		 */
+		virtual void forwardPass(const op::Array<float>& inputNetData, const op::Point<int>& inputDataSize,
+			const std::vector<double>& scaleInputToNetInputs) = 0;
+
+		/**
+		 * Keypoints of the last forwardPass(), {people, body parts, 3}. Valid until the next forwardPass().
+		 */
+		virtual op::Array<float> getPoseKeypoints() const = 0;
+
+		virtual double getScaleNetToOutput() const = 0;
+
+		/**
+		 * It adds the durations of the steps of the last forwardPass() (OPENPOSE_STAGE_NETWORK_FORWARD,
+		 * OPENPOSE_STAGE_RESIZE_AND_NMS and OPENPOSE_STAGE_BODY_PART_CONNECTION) to `stageStatistics`, if the engine
+		 * times them separately.
+		 */
+		virtual void addStepDurations(StageStatistics& stageStatistics) const = 0;
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_POSE_ENGINE_HPP
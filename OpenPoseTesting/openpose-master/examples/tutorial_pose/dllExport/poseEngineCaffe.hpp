@@ -0,0 +1,61 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_POSE_ENGINE_CAFFE_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_POSE_ENGINE_CAFFE_HPP
+
+// C++ std library dependencies
+#include <memory>
+#include <string>
+#include <vector>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "poseEngine.hpp"
+
+namespace dllExport
+{
+	/**
+	 * PoseEngineCaffe: PoseEngine running op::PoseExtractorCaffe (Caffe network, GPU post-processing in CUDA builds).
+	 */
+	class PoseEngineCaffe : public PoseEngine
+	{
+	public:
+		PoseEngineCaffe(const op::PoseModel poseModel, const std::string& modelFolder, const int gpuNumberStart) :
+			spPoseExtractorCaffe{std::make_shared<op::PoseExtractorCaffe>(poseModel, modelFolder, gpuNumberStart,
+				std::vector<op::HeatMapType>{}, op::ScaleMode::ZeroToOne, true)}
+		{
+		}
+
+		void initializationOnThread()
+		{
+			spPoseExtractorCaffe->initializationOnThread();
+		}
+
+		void forwardPass(const op::Array<float>& inputNetData, const op::Point<int>& inputDataSize,
+			const std::vector<double>& scaleInputToNetInputs)
+		{
+			spPoseExtractorCaffe->forwardPass(inputNetData, inputDataSize, scaleInputToNetInputs);
+		}
+
+		op::Array<float> getPoseKeypoints() const
+		{
+			return spPoseExtractorCaffe->getPoseKeypoints();
+		}
+
+		double getScaleNetToOutput() const
+		{
+			return spPoseExtractorCaffe->getScaleNetToOutput();
+		}
+
+		void addStepDurations(StageStatistics& stageStatistics) const
+		{
+			// op::PoseExtractorCaffe::forwardPass runs all the steps (asynchronously on the GPU in CUDA builds)
+			(void)stageStatistics;
+		}
+
+	private:
+		const std::shared_ptr<op::PoseExtractorCaffe> spPoseExtractorCaffe;
+
+		DELETE_COPY(PoseEngineCaffe);
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_POSE_ENGINE_CAFFE_HPP
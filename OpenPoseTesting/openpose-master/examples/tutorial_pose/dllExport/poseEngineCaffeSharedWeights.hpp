@@ -0,0 +1,148 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_POSE_ENGINE_CAFFE_SHARED_WEIGHTS_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_POSE_ENGINE_CAFFE_SHARED_WEIGHTS_HPP
+
+// C++ std library dependencies
+#include <algorithm> // std::copy
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+// Caffe dependencies
+#ifdef USE_CAFFE
+	#include <caffe/net.hpp>
+#endif
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "caffeWeightStore.hpp"
+#include "poseCpuPostProcessing.hpp"
+#include "poseEngine.hpp"
+#include "timestamp.hpp"
+
+namespace dllExport
+{
+	/**
+	 * PoseEngineCaffeSharedWeights: PoseEngine running its own Caffe network whose weights come from CaffeWeightStore,
+	 * so every engine of the process with the same model and GPU reads one copy of the caffemodel, and only allocates
+	 * its own activations. It is followed by PoseCpuPostProcessing.
+	 * op::PoseExtractorCaffe owns its network (and op::Wrapper its extractors), so it cannot be given shared weights:
+	 * this engine builds the network itself, with the same prototxt, caffemodel and output blob as op::NetCaffe. In
+	 * CUDA builds the network runs on the GPU and its output is copied back for the post-processing.
+	 */
+	class PoseEngineCaffeSharedWeights : public PoseEngine
+	{
+	public:
+		PoseEngineCaffeSharedWeights(const op::PoseModel poseModel, const std::string& modelFolder, const int gpuId) :
+			mPrototxtPath{modelFolder + op::POSE_PROTOTXT.at((int)poseModel)},
+			mCaffeModelPath{modelFolder + op::POSE_TRAINED_MODEL.at((int)poseModel)},
+			mGpuId{gpuId},
+			mPoseCpuPostProcessing{poseModel},
+			mForwardNs{0ll}
+		{
+			#ifndef USE_CAFFE
+				op::error("The shared-weight pose engine requires Caffe.", __LINE__, __FUNCTION__, __FILE__);
+			#endif
+		}
+
+		void initializationOnThread()
+		{
+			try
+			{
+				#ifdef USE_CAFFE
+					// Caffe mode and device are per thread
+					#ifdef USE_CUDA
+						caffe::Caffe::set_mode(caffe::Caffe::GPU);
+						caffe::Caffe::SetDevice(mGpuId);
+					#else
+						caffe::Caffe::set_mode(caffe::Caffe::CPU);
+					#endif
+					spWeightOwner = CaffeWeightStore::getInstance().acquire(mPrototxtPath, mCaffeModelPath, mGpuId);
+					// Its own parameter blobs are replaced by (and freed for) the ones of the weight owner
+					upCaffeNet.reset(new caffe::Net<float>{mPrototxtPath, caffe::TEST});
+					upCaffeNet->ShareTrainedLayersWith(spWeightOwner.get());
+					spOutputBlob = upCaffeNet->blob_by_name("net_output");
+				#endif
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+		void forwardPass(const op::Array<float>& inputNetData, const op::Point<int>& inputDataSize,
+			const std::vector<double>& scaleInputToNetInputs)
+		{
+			try
+			{
+				#ifdef USE_CAFFE
+					(void)inputDataSize;
+					const auto beginNs = getTimestampNs();
+					if (inputNetData.getNumberDimensions() != 4 || inputNetData.getSize(1) != 3
+						|| inputNetData.getSize(0) != (int)scaleInputToNetInputs.size())
+						op::error("inputNetData must be {number scales, 3, height, width}.",
+							__LINE__, __FUNCTION__, __FILE__);
+					// Network (only reshaped when the input size changes)
+					auto* inputBlob = upCaffeNet->input_blobs().at(0);
+					const std::vector<int> inputSize{inputNetData.getSize(0), 3, inputNetData.getSize(2),
+						inputNetData.getSize(3)};
+					if (inputBlob->shape() != inputSize)
+					{
+						inputBlob->Reshape(inputSize);
+						upCaffeNet->Reshape();
+					}
+					const auto* const inputPtr = inputNetData.getConstPtr();
+					std::copy(inputPtr, inputPtr + inputNetData.getVolume(), inputBlob->mutable_cpu_data());
+					upCaffeNet->ForwardFrom(0);
+					const auto* const netOutputPtr = spOutputBlob->cpu_data();
+					mForwardNs = getTimestampNs() - beginNs;
+					mPoseCpuPostProcessing.process(netOutputPtr, std::array<int, 4>{spOutputBlob->shape(0),
+						spOutputBlob->shape(1), spOutputBlob->shape(2), spOutputBlob->shape(3)},
+						op::Point<int>{inputSize[3], inputSize[2]}, scaleInputToNetInputs);
+				#else
+					(void)inputNetData;
+					(void)inputDataSize;
+					(void)scaleInputToNetInputs;
+				#endif
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+		op::Array<float> getPoseKeypoints() const
+		{
+			return mPoseCpuPostProcessing.getPoseKeypoints();
+		}
+
+		double getScaleNetToOutput() const
+		{
+			return mPoseCpuPostProcessing.getScaleNetToOutput();
+		}
+
+		void addStepDurations(StageStatistics& stageStatistics) const
+		{
+			stageStatistics.add(OPENPOSE_STAGE_NETWORK_FORWARD, mForwardNs);
+			stageStatistics.add(OPENPOSE_STAGE_RESIZE_AND_NMS, mPoseCpuPostProcessing.getResizeAndNmsNs());
+			stageStatistics.add(OPENPOSE_STAGE_BODY_PART_CONNECTION, mPoseCpuPostProcessing.getConnectionNs());
+		}
+
+	private:
+		const std::string mPrototxtPath;
+		const std::string mCaffeModelPath;
+		const int mGpuId;
+		#ifdef USE_CAFFE
+			// Declared before the network, so the weights outlive it
+			std::shared_ptr<caffe::Net<float>> spWeightOwner;
+			std::unique_ptr<caffe::Net<float>> upCaffeNet;
+			boost::shared_ptr<caffe::Blob<float>> spOutputBlob;
+		#endif
+		PoseCpuPostProcessing mPoseCpuPostProcessing;
+		// Network step of the last forwardPass()
+		long long mForwardNs;
+
+		DELETE_COPY(PoseEngineCaffeSharedWeights);
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_POSE_ENGINE_CAFFE_SHARED_WEIGHTS_HPP
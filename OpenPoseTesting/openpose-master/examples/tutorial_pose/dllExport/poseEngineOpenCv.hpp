@@ -0,0 +1,123 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_POSE_ENGINE_OPEN_CV_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_POSE_ENGINE_OPEN_CV_HPP
+
+// C++ std library dependencies
+#include <array>
+#include <string>
+#include <vector>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+#include <openpose/core/netOpenCv.hpp>
+// DLL dependencies
+#include "int8Calibration.hpp"
+#include "poseCpuPostProcessing.hpp"
+#include "poseEngine.hpp"
+#include "timestamp.hpp"
+
+namespace dllExport
+{
+	/**
+	 * PoseEngineOpenCv: PoseEngine running the pose network through op::NetOpenCv (same prototxt/caffemodel on the
+	 * OpenCV dnn module, on the CPU), followed by PoseCpuPostProcessing.
+	 * The OpenCV convolutions are much faster on CPU than the Caffe im2col + GEMM path, which makes this the engine of
+	 * the machines without GPU.
+	 * If `int8CalibrationPath` is not empty (OpenCV 4.6 or later), the network is quantized to int8 when it is loaded,
+	 * calibrated with the images of that file (see openPoseCalibrateInt8). Inputs and outputs stay in float, so only the
+	 * network itself changes.
+	 */
+	class PoseEngineOpenCv : public PoseEngine
+	{
+	public:
+		PoseEngineOpenCv(const op::PoseModel poseModel, const std::string& modelFolder,
+			const std::string& int8CalibrationPath = "") :
+			mPoseModel{poseModel},
+			mInt8CalibrationPath{int8CalibrationPath},
+			mNetOpenCv{modelFolder + op::POSE_PROTOTXT.at((int)poseModel),
+				modelFolder + op::POSE_TRAINED_MODEL.at((int)poseModel)},
+			mPoseCpuPostProcessing{poseModel},
+			mForwardNs{0ll}
+		{
+			#ifndef OPENPOSE_DLL_EXPORT_OPENCV_DNN_INT8
+				if (!mInt8CalibrationPath.empty())
+					op::error("The int8 OpenCV pose engine requires OpenCV 4.6 or later (cv::dnn::Net::quantize).",
+						__LINE__, __FUNCTION__, __FILE__);
+			#endif
+		}
+
+		void initializationOnThread()
+		{
+			try
+			{
+				mNetOpenCv.initializationOnThread();
+				if (!mInt8CalibrationPath.empty())
+				{
+					const auto int8Calibration = readInt8Calibration(mInt8CalibrationPath);
+					if (int8Calibration.poseModel != mPoseModel)
+						op::error("The int8 calibration file " + mInt8CalibrationPath + " was made for another pose"
+							" model.", __LINE__, __FUNCTION__, __FILE__);
+					op::log("Quantizing the pose network to int8 from the " + std::to_string(
+						int8Calibration.imagePaths.size()) + " images of " + mInt8CalibrationPath + ".",
+						op::Priority::High);
+					mNetOpenCv.quantize(createCalibrationInputs(int8Calibration));
+				}
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+		void forwardPass(const op::Array<float>& inputNetData, const op::Point<int>& inputDataSize,
+			const std::vector<double>& scaleInputToNetInputs)
+		{
+			try
+			{
+				(void)inputDataSize;
+				const auto beginNs = getTimestampNs();
+				if (inputNetData.getNumberDimensions() != 4 || inputNetData.getSize(1) != 3
+					|| inputNetData.getSize(0) != (int)scaleInputToNetInputs.size())
+					op::error("inputNetData must be {number scales, 3, height, width}.",
+						__LINE__, __FUNCTION__, __FILE__);
+				mNetOpenCv.forwardPass(inputNetData);
+				const auto netOutput = mNetOpenCv.getOutputBlob();
+				mForwardNs = getTimestampNs() - beginNs;
+				mPoseCpuPostProcessing.process(netOutput.ptr<float>(), std::array<int, 4>{netOutput.size[0],
+					netOutput.size[1], netOutput.size[2], netOutput.size[3]},
+					op::Point<int>{inputNetData.getSize(3), inputNetData.getSize(2)}, scaleInputToNetInputs);
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+		op::Array<float> getPoseKeypoints() const
+		{
+			return mPoseCpuPostProcessing.getPoseKeypoints();
+		}
+
+		double getScaleNetToOutput() const
+		{
+			return mPoseCpuPostProcessing.getScaleNetToOutput();
+		}
+
+		void addStepDurations(StageStatistics& stageStatistics) const
+		{
+			stageStatistics.add(OPENPOSE_STAGE_NETWORK_FORWARD, mForwardNs);
+			stageStatistics.add(OPENPOSE_STAGE_RESIZE_AND_NMS, mPoseCpuPostProcessing.getResizeAndNmsNs());
+			stageStatistics.add(OPENPOSE_STAGE_BODY_PART_CONNECTION, mPoseCpuPostProcessing.getConnectionNs());
+		}
+
+	private:
+		const op::PoseModel mPoseModel;
+		const std::string mInt8CalibrationPath;
+		op::NetOpenCv mNetOpenCv;
+		PoseCpuPostProcessing mPoseCpuPostProcessing;
+		// Network step of the last forwardPass()
+		long long mForwardNs;
+
+		DELETE_COPY(PoseEngineOpenCv);
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_POSE_ENGINE_OPEN_CV_HPP
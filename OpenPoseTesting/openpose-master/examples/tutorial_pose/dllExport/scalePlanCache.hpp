@@ -0,0 +1,90 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_SCALE_PLAN_CACHE_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_SCALE_PLAN_CACHE_HPP
+
+// C++ std library dependencies
+#include <deque>
+#include <tuple>
+#include <vector>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+
+namespace dllExport
+{
+	/**
+	 * Output of op::ScaleAndSizeExtractor::extract for a given input resolution.
+	 */
+	struct ScalePlan
+	{
+		op::Point<int> inputResolution;
+		std::vector<double> scaleInputToNetInputs;
+		std::vector<op::Point<int>> netInputSizes;
+		double scaleInputToOutput;
+		op::Point<int> outputResolution;
+	};
+
+	/**
+	 * ScalePlanCache: op::ScaleAndSizeExtractor memoized per input resolution.
+	 * The scale plan only depends on the input resolution (the net and output resolutions, number of scales and scale gap
+	 * are fixed at construction), so it is computed once per resolution. The last `capacity` resolutions are kept, which
+	 * covers a fixed-size video (1 entry) as well as image lists that alternate a few sizes.
+	 * Not thread-safe.
+	 */
+	class ScalePlanCache
+	{
+	public:
+		ScalePlanCache(const op::Point<int>& netInputResolution, const op::Point<int>& outputResolution,
+			const int scaleNumber, const double scaleGap, const unsigned int capacity = 4u) :
+			mScaleAndSizeExtractor{netInputResolution, outputResolution, scaleNumber, scaleGap},
+			mCapacity{capacity > 0u ? capacity : 1u}
+		{
+		}
+
+		/**
+		 * @return The plan of `inputResolution`. The reference is valid until the next call.
+		 */
+		const ScalePlan& extract(const op::Point<int>& inputResolution)
+		{
+			try
+			{
+				for (auto scalePlan = mScalePlans.begin() ; scalePlan != mScalePlans.end() ; scalePlan++)
+				{
+					if (scalePlan->inputResolution.x == inputResolution.x
+						&& scalePlan->inputResolution.y == inputResolution.y)
+					{
+						// Most recent first, so a fixed resolution is always found at the first comparison
+						if (scalePlan != mScalePlans.begin())
+						{
+							auto recentScalePlan = std::move(*scalePlan);
+							mScalePlans.erase(scalePlan);
+							mScalePlans.emplace_front(std::move(recentScalePlan));
+						}
+						return mScalePlans.front();
+					}
+				}
+				ScalePlan scalePlan;
+				scalePlan.inputResolution = inputResolution;
+				std::tie(scalePlan.scaleInputToNetInputs, scalePlan.netInputSizes, scalePlan.scaleInputToOutput,
+					scalePlan.outputResolution) = mScaleAndSizeExtractor.extract(inputResolution);
+				if (mScalePlans.size() >= mCapacity)
+					mScalePlans.pop_back();
+				mScalePlans.emplace_front(std::move(scalePlan));
+				return mScalePlans.front();
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+				static const ScalePlan emptyScalePlan{};
+				return emptyScalePlan;
+			}
+		}
+
+	private:
+		const op::ScaleAndSizeExtractor mScaleAndSizeExtractor;
+		const unsigned int mCapacity;
+		std::deque<ScalePlan> mScalePlans;
+
+		DELETE_COPY(ScalePlanCache);
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_SCALE_PLAN_CACHE_HPP
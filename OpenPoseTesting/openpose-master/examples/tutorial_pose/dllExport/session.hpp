@@ -0,0 +1,306 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_SESSION_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_SESSION_HPP
+
+// C++ std library dependencies
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "hostDatum.hpp"
+#include "keypointCallback.hpp"
+#include "keypointRing.hpp"
+#include "stageStatistics.hpp"
+#include "timestamp.hpp"
+#include "wHostFrameRelease.hpp"
+#include "wKeypointRing.hpp"
+#include "wLatestFrameInput.hpp"
+
+namespace dllExport
+{
+	typedef std::vector<HostDatum> SessionDatums;
+	typedef std::shared_ptr<SessionDatums> SessionDatumsPtr;
+
+	/**
+	 * Everything required to configure an op::Wrapper, i.e. the arguments of op::Wrapper::configure plus the threading
+	 * mode.
+	 */
+	struct SessionConfiguration
+	{
+		op::WrapperStructPose pose;
+		op::WrapperStructFace face;
+		op::WrapperStructHand hand;
+		op::WrapperStructInput input;
+		op::WrapperStructOutput output;
+		bool disableMultiThreading;
+		// If true, frames are pushed by the host with pushFrame() instead of read from `input.producerSharedPtr`
+		bool pushInput;
+		// If true, every wrapper queue holds a single frame and pushed frames replace the pending one (low latency)
+		bool latestFrameOnly;
+		// Maximum number of people stored per frame in the keypoint ring
+		int keypointRingMaxPeople;
+		// Optional host callback fired by the post-processing worker
+		OpenPoseKeypointCallback keypointCallback;
+		void* keypointCallbackUserData;
+		// If true, the keypoints are rendered straight into the 8-bit cvOutputData (see Uint8KeypointRenderer) instead of
+		// by the wrapper renderers on the float output array
+		bool renderUint8;
+		// Optional host heat map callback, fired after the keypoint one with the heat maps in `heatMapFormat`
+		OpenPoseHeatmapCallback heatMapCallback;
+		void* heatMapCallbackUserData;
+		int heatMapFormat;
+	};
+
+	/**
+	 * Session: an op::Wrapper running on its own threads.
+	 * Contrary to op::Wrapper::exec(), start() returns as soon as the threads have been spawned, so it can be driven from
+	 * the frame loop of the host application. The networks are loaded on the wrapper threads (initializationOnThread).
+	 */
+	class Session
+	{
+	public:
+		explicit Session(const SessionConfiguration& sessionConfiguration) :
+			mPushInput{sessionConfiguration.pushInput},
+			// The latest-frame input worker replaces the asynchronous input queue
+			mWrapper{mPushInput && !sessionConfiguration.latestFrameOnly
+				? op::ThreadManagerMode::AsynchronousIn : op::ThreadManagerMode::Synchronous},
+			mNextFrameId{0ull},
+			mFirstFrameIdOfOwner{0ull}
+		{
+			try
+			{
+				if (mPushInput && sessionConfiguration.input.producerSharedPtr != nullptr)
+					op::error("A push-input session cannot have a producer.", __LINE__, __FUNCTION__, __FILE__);
+				spKeypointRing = std::make_shared<KeypointRing>(
+					(int)op::POSE_NUMBER_BODY_PARTS.at((int)sessionConfiguration.pose.poseModel),
+					(sessionConfiguration.face.enable ? (int)op::FACE_NUMBER_PARTS : 0),
+					(sessionConfiguration.hand.enable ? (int)op::HAND_NUMBER_PARTS : 0),
+					sessionConfiguration.keypointRingMaxPeople);
+				spStageStatistics = std::make_shared<StageStatistics>();
+				spHostFrameTracker = std::make_shared<HostFrameTracker>();
+				// Latest-frame-only: a frame can only wait in front of each stage while the stage is busy, so the latency
+				// is bounded by the stage times instead of the queue lengths. The wrapper queues block their producer
+				// when full, so only the host input (the mailbox) overwrites, and the slower stages make the upstream
+				// stages wait, which makes the mailbox drop the frames the pipeline cannot take.
+				if (sessionConfiguration.latestFrameOnly)
+				{
+					mWrapper.setDefaultMaxSizeQueues(1);
+					if (mPushInput)
+					{
+						spLatestFrameMailbox = std::make_shared<LatestFrameMailbox<SessionDatumsPtr>>();
+						mWrapper.setWorkerInput(
+							std::make_shared<WLatestFrameInput<SessionDatumsPtr>>(spLatestFrameMailbox), false);
+					}
+				}
+				// Host frames are released (and the host callback fired) right after the extraction and rendering workers
+				const auto spKeypointCallback = (sessionConfiguration.keypointCallback != nullptr
+					? std::make_shared<KeypointCallback>(sessionConfiguration.keypointCallback,
+						sessionConfiguration.keypointCallbackUserData)
+					: nullptr);
+				const auto spHeatMapCallback = (sessionConfiguration.heatMapCallback != nullptr
+					? std::make_shared<HeatMapCallback>(sessionConfiguration.heatMapCallback,
+						sessionConfiguration.heatMapCallbackUserData, sessionConfiguration.heatMapFormat,
+						sessionConfiguration.pose.heatMapScale)
+					: nullptr);
+				// Keypoint scaling: the wrapper keeps the keypoints in input resolution (the extractor one, for which its
+				// op::KeypointScaler does nothing) and the post-processing worker scales the pose, face and hand keypoints
+				// in a single vectorized pass
+				auto pose = sessionConfiguration.pose;
+				const auto spKeypointScaling = std::make_shared<KeypointScaling>(pose.keypointScale);
+				pose.keypointScale = op::ScaleMode::InputResolution;
+				// 8-bit output: the wrapper renderers are disabled, so op::Wrapper skips the float output array (both
+				// op::CvMatToOpOutput and op::OpOutputToCvMat) and the post-processing worker renders cvOutputData instead
+				auto face = sessionConfiguration.face;
+				auto hand = sessionConfiguration.hand;
+				std::shared_ptr<Uint8KeypointRenderer> spUint8KeypointRenderer;
+				if (sessionConfiguration.renderUint8 && pose.renderMode != op::RenderMode::None)
+				{
+					spUint8KeypointRenderer = std::make_shared<Uint8KeypointRenderer>(pose, face, hand);
+					pose.renderMode = op::RenderMode::None;
+					face.renderMode = op::RenderMode::None;
+					hand.renderMode = op::RenderMode::None;
+				}
+				mWrapper.setWorkerPostProcessing(std::make_shared<WHostFrameRelease<SessionDatumsPtr>>(
+					spStageStatistics, spKeypointScaling, spKeypointCallback, spUint8KeypointRenderer, spHeatMapCallback),
+					false);
+				// Keypoints are published to the host by the output stage
+				mWrapper.setWorkerOutput(
+					std::make_shared<WKeypointRing<SessionDatumsPtr>>(spKeypointRing, spStageStatistics), false);
+				mWrapper.configure(pose, face, hand, sessionConfiguration.input, sessionConfiguration.output);
+				// Set to single-thread running (to debug and/or reduce latency)
+				if (sessionConfiguration.disableMultiThreading)
+					mWrapper.disableMultiThreading();
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+		~Session()
+		{
+			try
+			{
+				stop();
+			}
+			catch (const std::exception& e)
+			{
+				op::log(e.what(), op::Priority::Max, __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+		void start()
+		{
+			try
+			{
+				const std::lock_guard<std::mutex> lock{mControlMutex};
+				startUnlocked();
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+		void stop()
+		{
+			try
+			{
+				const std::lock_guard<std::mutex> lock{mControlMutex};
+				stopUnlocked();
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+		bool isRunning() const
+		{
+			try
+			{
+				return mWrapper.isRunning();
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+				return false;
+			}
+		}
+
+		/**
+		 * It enqueues a frame without blocking. The frame is not copied: `cvInputData` keeps pointing to the host memory,
+		 * which `spHostFrameLease` keeps alive until the post-processing stage releases it.
+		 * @return OPENPOSE_OK if the frame was enqueued, OPENPOSE_FRAME_DROPPED if it was not (input queue full, the frame
+		 * and its lease are dropped). In latest-frame-only mode it is always enqueued, and OPENPOSE_FRAME_REPLACED means
+		 * that the previously pushed frame, still waiting to enter the pipeline, was dropped (and its lease released)
+		 * instead.
+		 */
+		int pushFrame(const cv::Mat& cvInputData, std::shared_ptr<HostFrameLease> spHostFrameLease)
+		{
+			try
+			{
+				if (!mPushInput)
+					op::error("Frames can only be pushed into push-input sessions.", __LINE__, __FUNCTION__, __FILE__);
+				if (!mWrapper.isRunning())
+					op::error("The session must be started before pushing frames.", __LINE__, __FUNCTION__, __FILE__);
+				auto datumsPtr = std::make_shared<SessionDatums>(1);
+				auto& datum = datumsPtr->at(0);
+				datum.id = mNextFrameId++;
+				datum.cvInputData = cvInputData;
+				if (spHostFrameLease != nullptr)
+				{
+					datum.pHostFrameData = cvInputData.data;
+					spHostFrameLease->track(spHostFrameTracker);
+				}
+				datum.spHostFrameLease = std::move(spHostFrameLease);
+				datum.inputTimestampNs = getTimestampNs();
+				if (spLatestFrameMailbox != nullptr)
+					return (spLatestFrameMailbox->put(std::move(datumsPtr)) ? OPENPOSE_FRAME_REPLACED : OPENPOSE_OK);
+				return (mWrapper.tryEmplace(datumsPtr) ? OPENPOSE_OK : OPENPOSE_FRAME_DROPPED);
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+				return OPENPOSE_ERROR;
+			}
+		}
+
+		/**
+		 * Lock-free and allocation-free read of the latest published keypoints. See KeypointRing::pollLatest.
+		 * Frames pushed before the last resetOwner() are not reported.
+		 */
+		bool pollKeypoints(OpenPoseKeypointFrame& frame) const
+		{
+			// Checked inside the ring, so the frames of the previous owner never reach the host buffers
+			return spKeypointRing->pollLatest(frame, mFirstFrameIdOfOwner.load());
+		}
+
+		/**
+		 * It hands a running session over to a new user (see SessionCache): the results of the frames pushed so far
+		 * (possibly still in flight) are hidden from pollKeypoints().
+		 */
+		void resetOwner()
+		{
+			mFirstFrameIdOfOwner = mNextFrameId.load();
+		}
+
+		/**
+		 * It blocks until every pushed host frame is released, i.e. until no worker reads host memory anymore.
+		 * @return False if the session stopped meanwhile (its queued frames are then only released when it is destroyed).
+		 */
+		bool waitForHostFrames() const
+		{
+			while (!spHostFrameTracker->waitForAll(std::chrono::milliseconds{10}))
+				if (!mWrapper.isRunning())
+					return false;
+			return true;
+		}
+
+		/**
+		 * Durations of the stages observable from the DLL workers (see OpenPoseStage).
+		 */
+		StageStatistics& getStageStatistics()
+		{
+			return *spStageStatistics;
+		}
+
+	private:
+		const bool mPushInput;
+		op::Wrapper<SessionDatums> mWrapper;
+		std::atomic<unsigned long long> mNextFrameId;
+		std::atomic<unsigned long long> mFirstFrameIdOfOwner;
+		std::shared_ptr<KeypointRing> spKeypointRing;
+		std::shared_ptr<StageStatistics> spStageStatistics;
+		std::shared_ptr<HostFrameTracker> spHostFrameTracker;
+		// Only for latest-frame-only push-input sessions
+		std::shared_ptr<LatestFrameMailbox<SessionDatumsPtr>> spLatestFrameMailbox;
+		// Serializes start() and stop(), isRunning() does not need it
+		std::mutex mControlMutex;
+
+		void startUnlocked()
+		{
+			if (!mWrapper.isRunning())
+			{
+				op::log("Starting thread(s)", op::Priority::High);
+				mWrapper.start();
+			}
+		}
+
+		void stopUnlocked()
+		{
+			if (mWrapper.isRunning())
+			{
+				op::log("Stopping thread(s)", op::Priority::High);
+				mWrapper.stop();
+			}
+		}
+
+		DELETE_COPY(Session);
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_SESSION_HPP
@@ -0,0 +1,166 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_SESSION_CACHE_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_SESSION_CACHE_HPP
+
+// C++ std library dependencies
+#include <algorithm> // std::max
+#include <deque>
+#include <iterator> // std::next
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility> // std::pair
+#include <vector>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "session.hpp"
+
+namespace dllExport
+{
+	/**
+	 * It identifies the pipelines that can be reused for a given configuration. Besides the pose model, model folder and
+	 * net resolutions, it contains every other setting baked into the wrapper workers at configure() time (rendering,
+	 * output writers, threading, host callback...), so a reused session behaves exactly as a freshly created one.
+	 */
+	inline std::string getSessionCacheKey(const SessionConfiguration& sessionConfiguration)
+	{
+		try
+		{
+			const auto& pose = sessionConfiguration.pose;
+			const auto& face = sessionConfiguration.face;
+			const auto& hand = sessionConfiguration.hand;
+			const auto& output = sessionConfiguration.output;
+			std::ostringstream key;
+			key << "pose:" << pose.enable << "," << (int)pose.poseModel << "," << pose.modelFolder
+				<< "," << pose.netInputSize.x << "x" << pose.netInputSize.y
+				<< "," << pose.outputSize.x << "x" << pose.outputSize.y << "," << (int)pose.keypointScale
+				<< "," << pose.gpuNumber << "," << pose.gpuNumberStart << "," << pose.scalesNumber << "," << pose.scaleGap
+				<< "," << (int)pose.renderMode << "," << pose.blendOriginalFrame << "," << pose.alphaKeypoint
+				<< "," << pose.alphaHeatMap << "," << pose.defaultPartToRender << "," << (int)pose.heatMapScale
+				<< "," << pose.renderThreshold << "," << pose.identification << ",heatMaps";
+			for (const auto heatMapType : pose.heatMapTypes)
+				key << ":" << (int)heatMapType;
+			key << "|face:" << face.enable << "," << face.netInputSize.x << "x" << face.netInputSize.y
+				<< "," << (int)face.renderMode << "," << face.alphaKeypoint << "," << face.alphaHeatMap
+				<< "," << face.renderThreshold
+				<< "|hand:" << hand.enable << "," << hand.netInputSize.x << "x" << hand.netInputSize.y
+				<< "," << hand.scalesNumber << "," << hand.scaleRange << "," << hand.tracking
+				<< "," << (int)hand.renderMode << "," << hand.alphaKeypoint << "," << hand.alphaHeatMap
+				<< "," << hand.renderThreshold
+				<< "|output:" << output.displayGui << "," << output.guiVerbose << "," << output.fullScreen
+				<< "," << output.writeKeypoint << "," << (int)output.writeKeypointFormat << "," << output.writeKeypointJson
+				<< "," << output.writeCocoJson << "," << output.writeImages << "," << output.writeImagesFormat
+				<< "," << output.writeVideo << "," << output.writeHeatMaps << "," << output.writeHeatMapsFormat
+				<< "|session:" << sessionConfiguration.disableMultiThreading << "," << sessionConfiguration.pushInput
+				<< "," << sessionConfiguration.latestFrameOnly
+				<< "," << sessionConfiguration.keypointRingMaxPeople << "," << sessionConfiguration.renderUint8
+				<< "|callback:" << (void*)sessionConfiguration.keypointCallback << ","
+				<< sessionConfiguration.keypointCallbackUserData << "," << (void*)sessionConfiguration.heatMapCallback
+				<< "," << sessionConfiguration.heatMapCallbackUserData << "," << sessionConfiguration.heatMapFormat;
+			return key.str();
+		}
+		catch (const std::exception& e)
+		{
+			op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			return "";
+		}
+	}
+
+	/**
+	 * SessionCache: process-wide pool of idle, still-running push-input sessions.
+	 * Caffe loads the networks in initializationOnThread() of the wrapper threads, and op::Wrapper does not accept
+	 * already-initialized extractors, so the only way to keep a network warm is to keep its threads alive. A session
+	 * released here stays started (its threads just wait for input frames) and acquire() hands it to the next session
+	 * with the same key, which skips both the wrapper configuration and the network loading.
+	 */
+	class SessionCache
+	{
+	public:
+		static SessionCache& getInstance()
+		{
+			static SessionCache sessionCache;
+			return sessionCache;
+		}
+
+		~SessionCache()
+		{
+			// Joining threads while the library is being unloaded can deadlock (e.g. under the Windows loader lock), so
+			// the remaining sessions are intentionally leaked. Call clear() before unloading to release them cleanly.
+			for (auto& idleSession : mIdleSessions)
+				new std::shared_ptr<Session>{std::move(idleSession.second)};
+		}
+
+		/**
+		 * @return An idle session for `key`, or nullptr if there is none.
+		 */
+		std::shared_ptr<Session> acquire(const std::string& key)
+		{
+			try
+			{
+				const std::lock_guard<std::mutex> lock{mMutex};
+				for (auto idleSession = mIdleSessions.rbegin() ; idleSession != mIdleSessions.rend() ; idleSession++)
+				{
+					if (idleSession->first == key)
+					{
+						auto spSession = std::move(idleSession->second);
+						mIdleSessions.erase(std::next(idleSession).base());
+						op::log("Reusing a warm OpenPose session.", op::Priority::High);
+						return spSession;
+					}
+				}
+				return nullptr;
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+				return nullptr;
+			}
+		}
+
+		/**
+		 * It parks a running session for later reuse. If more than `maxIdleSessions` sessions are then idle, the oldest
+		 * ones are stopped and destroyed (outside the cache lock, since stopping joins their threads).
+		 */
+		void release(const std::string& key, std::shared_ptr<Session> spSession, const int maxIdleSessions)
+		{
+			try
+			{
+				std::vector<std::shared_ptr<Session>> evictedSessions;
+				{
+					const std::lock_guard<std::mutex> lock{mMutex};
+					if (spSession != nullptr && spSession->isRunning())
+						mIdleSessions.emplace_back(key, std::move(spSession));
+					while (!mIdleSessions.empty() && (int)mIdleSessions.size() > std::max(maxIdleSessions, 0))
+					{
+						evictedSessions.emplace_back(std::move(mIdleSessions.front().second));
+						mIdleSessions.pop_front();
+					}
+				}
+				// spSession (if not parked) and evictedSessions are destroyed here
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+		/**
+		 * It stops and destroys every idle session.
+		 */
+		void clear()
+		{
+			release("", nullptr, 0);
+		}
+
+	private:
+		std::mutex mMutex;
+		std::deque<std::pair<std::string, std::shared_ptr<Session>>> mIdleSessions;
+
+		SessionCache() = default;
+
+		DELETE_COPY(SessionCache);
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_SESSION_CACHE_HPP
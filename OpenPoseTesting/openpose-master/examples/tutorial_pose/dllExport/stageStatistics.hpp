@@ -0,0 +1,103 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_STAGE_STATISTICS_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_STAGE_STATISTICS_HPP
+
+// C++ std library dependencies
+#include <algorithm> // std::max, std::min, std::nth_element
+#include <array>
+#include <mutex>
+#include <vector>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "../dllExportFile.hpp"
+
+namespace dllExport
+{
+	/**
+	 * StageStatistics: rolling window of the last `windowSize` durations of each OpenPoseStage.
+	 * add() is called once per frame and stage from the pipeline threads, so it only takes a short lock and never
+	 * allocates (the windows are allocated in the constructor). The percentiles are computed on demand by get().
+	 */
+	class StageStatistics
+	{
+	public:
+		explicit StageStatistics(const unsigned int windowSize = 1024u)
+		{
+			try
+			{
+				for (auto& window : mWindows)
+				{
+					window.durationsNs.resize(std::max(windowSize, 1u));
+					window.count = 0ull;
+				}
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+		void add(const int stage, const long long durationNs)
+		{
+			if (0 <= stage && stage < OPENPOSE_STAGE_COUNT)
+			{
+				const std::lock_guard<std::mutex> lock{mMutex};
+				auto& window = mWindows[stage];
+				window.durationsNs[window.count % window.durationsNs.size()] = durationNs;
+				window.count++;
+			}
+		}
+
+		OpenPoseStageStats get(const int stage) const
+		{
+			try
+			{
+				if (stage < 0 || stage >= OPENPOSE_STAGE_COUNT)
+					op::error("Unknown OpenPoseStage.", __LINE__, __FUNCTION__, __FILE__);
+				std::vector<long long> durationsNs;
+				OpenPoseStageStats stageStats;
+				{
+					const std::lock_guard<std::mutex> lock{mMutex};
+					const auto& window = mWindows[stage];
+					stageStats.count = window.count;
+					const auto numberSamples = (size_t)std::min(window.count, (unsigned long long)window.durationsNs.size());
+					durationsNs.assign(window.durationsNs.begin(), window.durationsNs.begin() + numberSamples);
+				}
+				stageStats.p50Ms = getPercentileMs(durationsNs, 0.50);
+				stageStats.p95Ms = getPercentileMs(durationsNs, 0.95);
+				stageStats.p99Ms = getPercentileMs(durationsNs, 0.99);
+				stageStats.maxMs = getPercentileMs(durationsNs, 1.);
+				return stageStats;
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+				return OpenPoseStageStats{};
+			}
+		}
+
+	private:
+		struct Window
+		{
+			std::vector<long long> durationsNs;
+			unsigned long long count;
+		};
+
+		mutable std::mutex mMutex;
+		std::array<Window, OPENPOSE_STAGE_COUNT> mWindows;
+
+		// Nearest-rank percentile, 0 if there is no sample
+		static double getPercentileMs(std::vector<long long>& durationsNs, const double percentile)
+		{
+			if (durationsNs.empty())
+				return 0.;
+			const auto rank = std::min((size_t)(percentile * durationsNs.size()), durationsNs.size() - 1);
+			std::nth_element(durationsNs.begin(), durationsNs.begin() + rank, durationsNs.end());
+			return durationsNs[rank] * 1e-6;
+		}
+
+		DELETE_COPY(StageStatistics);
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_STAGE_STATISTICS_HPP
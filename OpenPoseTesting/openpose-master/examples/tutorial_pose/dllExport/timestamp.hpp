@@ -0,0 +1,20 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_TIMESTAMP_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_TIMESTAMP_HPP
+
+// C++ std library dependencies
+#include <chrono>
+
+namespace dllExport
+{
+	/**
+	 * Clock of every timestamp reported through the C API (std::chrono::steady_clock, in nanoseconds), so the host can
+	 * subtract them from each other.
+	 */
+	inline long long getTimestampNs()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_TIMESTAMP_HPP
@@ -0,0 +1,151 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_UINT8_KEYPOINT_RENDERER_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_UINT8_KEYPOINT_RENDERER_HPP
+
+// C++ std library dependencies
+#include <algorithm> // std::max, std::min
+#include <cmath> // std::round, std::sqrt
+#include <vector>
+// OpenPose dependencies
+#include <opencv2/imgproc/imgproc.hpp> // cv::circle, cv::line, cv::resize
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "arrayView.hpp"
+#include "frameBufferPool.hpp"
+
+namespace dllExport
+{
+	/**
+	 * Uint8KeypointRenderer: CPU renderer that draws the pose, face and hand keypoints straight into an 8-bit BGR frame.
+	 * The renderers of op::Wrapper work on the op::Array<float> output frame, which costs a cv::Mat to float pass
+	 * (op::CvMatToOpOutput), a float to cv::Mat pass (op::OpOutputToCvMat) and 4 times the frame memory. When this
+	 * renderer is used, the wrapper renderers are disabled (so the wrapper skips both conversions) and this one builds
+	 * cvOutputData from cvInputData with a single 8-bit resize. It uses the same pairs and colors as the OpenPose CPU
+	 * renderers, without alpha blending (which the OpenPose CPU renderers do not apply either).
+	 */
+	class Uint8KeypointRenderer
+	{
+	public:
+		/**
+		 * It renders the parts whose render mode (`renderMode` of each structure) is not op::RenderMode::None, with the
+		 * same thresholds and background (`blendOriginalFrame`) the wrapper renderers would have used.
+		 */
+		Uint8KeypointRenderer(const op::WrapperStructPose& wrapperStructPose, const op::WrapperStructFace& wrapperStructFace,
+			const op::WrapperStructHand& wrapperStructHand) :
+			mPoseModel{wrapperStructPose.poseModel},
+			mBlendOriginalFrame{wrapperStructPose.blendOriginalFrame},
+			mRenderPose{wrapperStructPose.renderMode != op::RenderMode::None},
+			mRenderFace{wrapperStructFace.enable && wrapperStructFace.renderMode != op::RenderMode::None},
+			mRenderHand{wrapperStructHand.enable && wrapperStructHand.renderMode != op::RenderMode::None},
+			mPoseRenderThreshold{wrapperStructPose.renderThreshold},
+			mFaceRenderThreshold{wrapperStructFace.renderThreshold},
+			mHandRenderThreshold{wrapperStructHand.renderThreshold}
+		{
+		}
+
+		/**
+		 * It fills datum.cvOutputData (output resolution, i.e. cvInputData scaled by datum.scaleInputToOutput) with the
+		 * rendered keypoints. It must be called while datum.cvInputData is still valid, and before the keypoints are
+		 * scaled (i.e. while they are in input resolution, see KeypointScaling), which it maps to output resolution
+		 * while drawing them.
+		 */
+		void render(op::Datum& datum) const
+		{
+			try
+			{
+				if (datum.cvInputData.empty())
+					return;
+				const cv::Size outputSize{
+					std::max(1, (int)std::round(datum.cvInputData.cols * datum.scaleInputToOutput)),
+					std::max(1, (int)std::round(datum.cvInputData.rows * datum.scaleInputToOutput))};
+				// Background: the only full-frame pass, in 8 bits
+				cv::Mat cvOutputData;
+				cvOutputData.allocator = &FrameBufferPool::getInstance();
+				if (!mBlendOriginalFrame)
+				{
+					cvOutputData.create(outputSize, CV_8UC3);
+					cvOutputData.setTo(cv::Scalar{0, 0, 0});
+				}
+				else if (outputSize.width == datum.cvInputData.cols && outputSize.height == datum.cvInputData.rows)
+					datum.cvInputData.copyTo(cvOutputData);
+				else
+					cv::resize(datum.cvInputData, cvOutputData, outputSize, 0, 0, cv::INTER_LINEAR);
+				datum.cvOutputData = cvOutputData;
+				const auto thickness = std::max(1, (int)std::round(std::sqrt((double)outputSize.area()) / 300.));
+				const auto scaleInputToOutput = (float)datum.scaleInputToOutput;
+				if (mRenderPose)
+					renderKeypoints(datum.cvOutputData, datum.poseKeypoints,
+						op::POSE_BODY_PART_PAIRS_RENDER.at((int)mPoseModel), op::POSE_COLORS.at((int)mPoseModel),
+						mPoseRenderThreshold, scaleInputToOutput, 2 * thickness, 2 * thickness);
+				if (mRenderFace)
+					renderKeypoints(datum.cvOutputData, datum.faceKeypoints, op::FACE_PAIRS_RENDER,
+						op::FACE_COLORS_RENDER, mFaceRenderThreshold, scaleInputToOutput, thickness, thickness);
+				if (mRenderHand)
+					for (const auto& handKeypoints : datum.handKeypoints)
+						renderKeypoints(datum.cvOutputData, handKeypoints, op::HAND_PAIRS_RENDER, op::HAND_COLORS_RENDER,
+							mHandRenderThreshold, scaleInputToOutput, thickness, thickness);
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+	private:
+		const op::PoseModel mPoseModel;
+		const bool mBlendOriginalFrame;
+		const bool mRenderPose;
+		const bool mRenderFace;
+		const bool mRenderHand;
+		const float mPoseRenderThreshold;
+		const float mFaceRenderThreshold;
+		const float mHandRenderThreshold;
+
+		static void renderKeypoints(cv::Mat& frame, const op::Array<float>& keypoints,
+			const std::vector<unsigned int>& pairs, const std::vector<float>& colors, const float threshold,
+			const float scaleInputToOutput, const int lineThickness, const int radius)
+		{
+			const ArrayView<const float> keypointsView{keypoints};
+			if (keypointsView.empty() || colors.empty())
+				return;
+			const auto numberPeople = keypointsView.getSize(0);
+			const auto numberParts = keypointsView.getSize(1);
+			const auto numberColors = (unsigned int)colors.size();
+			// Input resolution keypoints drawn on the output resolution frame
+			const auto getPoint = [scaleInputToOutput](const float* keypoint)
+			{
+				return cv::Point{(int)std::round(keypoint[0] * scaleInputToOutput),
+					(int)std::round(keypoint[1] * scaleInputToOutput)};
+			};
+			// Colors are stored as RGB triplets
+			const auto getColor = [&colors, numberColors](const unsigned int index)
+			{
+				const auto colorIndex = (3 * index) % numberColors;
+				return cv::Scalar{colors[colorIndex + 2], colors[colorIndex + 1], colors[colorIndex]};
+			};
+			for (auto person = 0 ; person < numberPeople ; person++)
+			{
+				const auto* const personKeypoints = keypointsView.slice(person).getPtr();
+				// Lines
+				for (auto pair = 0u ; pair + 1 < pairs.size() ; pair += 2)
+				{
+					const auto* const keypointA = personKeypoints + 3 * pairs[pair];
+					const auto* const keypointB = personKeypoints + 3 * pairs[pair + 1];
+					if ((int)pairs[pair + 1] < numberParts && keypointA[2] > threshold && keypointB[2] > threshold)
+						cv::line(frame, getPoint(keypointA), getPoint(keypointB), getColor(pairs[pair + 1]),
+							lineThickness, cv::LINE_AA);
+				}
+				// Circles
+				for (auto part = 0 ; part < numberParts ; part++)
+				{
+					const auto* const keypoint = personKeypoints + 3 * part;
+					if (keypoint[2] > threshold)
+						cv::circle(frame, getPoint(keypoint), radius, getColor(part), -1, cv::LINE_AA);
+				}
+			}
+		}
+
+		DELETE_COPY(Uint8KeypointRenderer);
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_UINT8_KEYPOINT_RENDERER_HPP
@@ -0,0 +1,114 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_W_HOST_FRAME_RELEASE_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_W_HOST_FRAME_RELEASE_HPP
+
+// C++ std library dependencies
+#include <memory>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "hostDatum.hpp"
+#include "copyStatistics.hpp"
+#include "frameBufferPool.hpp"
+#include "heatMapCallback.hpp"
+#include "keypointCallback.hpp"
+#include "keypointScaling.hpp"
+#include "stageStatistics.hpp"
+#include "timestamp.hpp"
+#include "uint8KeypointRenderer.hpp"
+
+namespace dllExport
+{
+	/**
+	 * WHostFrameRelease: post-processing worker that hands the host frame buffers back as soon as the pose, face and
+	 * hand extractors and the renderers are done with them, i.e. before the (possibly slow) output workers.
+	 * op::Wrapper only takes one post-processing worker, so this one also renders cvOutputData in 8-bit output mode (see
+	 * Uint8KeypointRenderer) while cvInputData is still valid, scales the keypoints into `keypoint_scale` coordinates
+	 * (see KeypointScaling, the wrapper itself is configured to keep them in input resolution) and fires the host
+	 * keypoint and heat map callbacks (if any). The float heat maps are freed once given to the host.
+	 */
+	template<typename TDatums>
+	class WHostFrameRelease : public op::Worker<TDatums>
+	{
+	public:
+		WHostFrameRelease(const std::shared_ptr<StageStatistics>& stageStatistics,
+			const std::shared_ptr<KeypointScaling>& keypointScaling,
+			const std::shared_ptr<KeypointCallback>& keypointCallback = nullptr,
+			const std::shared_ptr<Uint8KeypointRenderer>& uint8KeypointRenderer = nullptr,
+			const std::shared_ptr<HeatMapCallback>& heatMapCallback = nullptr) :
+			spStageStatistics{stageStatistics},
+			spKeypointScaling{keypointScaling},
+			spKeypointCallback{keypointCallback},
+			spUint8KeypointRenderer{uint8KeypointRenderer},
+			spHeatMapCallback{heatMapCallback}
+		{
+		}
+
+		void initializationOnThread()
+		{
+		}
+
+		void work(TDatums& tDatums)
+		{
+			try
+			{
+				if (tDatums != nullptr)
+				{
+					const auto timestampNs = getTimestampNs();
+					for (auto& datum : *tDatums)
+					{
+						datum.postProcessingTimestampNs = timestampNs;
+						if (datum.inputTimestampNs > 0)
+							spStageStatistics->add(OPENPOSE_STAGE_EXTRACTION, timestampNs - datum.inputTimestampNs);
+						if (spUint8KeypointRenderer != nullptr)
+							spUint8KeypointRenderer->render(datum);
+						spKeypointScaling->scale(datum, op::Point<int>{datum.cvInputData.cols, datum.cvInputData.rows});
+						if (datum.spHostFrameLease != nullptr)
+						{
+							// The host frame should have travelled as a cv::Mat header pointing to the host memory
+							if (datum.cvInputData.data != datum.pHostFrameData)
+								CopyStatistics::getInstance().addPayloadCopy(
+									datum.cvInputData.total() * datum.cvInputData.elemSize(), "cvInputData");
+							// If any worker made cvOutputData point to the input frame, it must not outlive the lease
+							if (!datum.cvOutputData.empty() && datum.cvOutputData.data == datum.cvInputData.data)
+							{
+								cv::Mat cvOutputData;
+								cvOutputData.allocator = &FrameBufferPool::getInstance();
+								datum.cvOutputData.copyTo(cvOutputData);
+								datum.cvOutputData = cvOutputData;
+								CopyStatistics::getInstance().addPayloadCopy(
+									cvOutputData.total() * cvOutputData.elemSize(), "cvOutputData aliasing the host frame");
+							}
+							datum.cvInputData = cv::Mat{};
+							datum.pHostFrameData = nullptr;
+							datum.spHostFrameLease.reset();
+						}
+						if (spKeypointCallback != nullptr)
+							spKeypointCallback->fire(datum, datum.inputTimestampNs);
+						if (spHeatMapCallback != nullptr)
+						{
+							spHeatMapCallback->fire(datum);
+							datum.poseHeatMaps.reset();
+						}
+					}
+				}
+			}
+			catch (const std::exception& e)
+			{
+				this->stop();
+				tDatums = nullptr;
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+	private:
+		const std::shared_ptr<StageStatistics> spStageStatistics;
+		const std::shared_ptr<KeypointScaling> spKeypointScaling;
+		const std::shared_ptr<KeypointCallback> spKeypointCallback;
+		const std::shared_ptr<Uint8KeypointRenderer> spUint8KeypointRenderer;
+		const std::shared_ptr<HeatMapCallback> spHeatMapCallback;
+
+		DELETE_COPY(WHostFrameRelease);
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_W_HOST_FRAME_RELEASE_HPP
@@ -0,0 +1,66 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_W_KEYPOINT_RING_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_W_KEYPOINT_RING_HPP
+
+// C++ std library dependencies
+#include <memory>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+// DLL dependencies
+#include "keypointRing.hpp"
+#include "stageStatistics.hpp"
+#include "timestamp.hpp"
+
+namespace dllExport
+{
+	/**
+	 * WKeypointRing: output worker that publishes the keypoints of each processed frame into a KeypointRing, so the host
+	 * can read them without going through the file writers.
+	 */
+	template<typename TDatums>
+	class WKeypointRing : public op::WorkerConsumer<TDatums>
+	{
+	public:
+		WKeypointRing(const std::shared_ptr<KeypointRing>& keypointRing,
+			const std::shared_ptr<StageStatistics>& stageStatistics) :
+			spKeypointRing{keypointRing},
+			spStageStatistics{stageStatistics}
+		{
+		}
+
+		void initializationOnThread()
+		{
+		}
+
+		void workConsumer(const TDatums& tDatums)
+		{
+			try
+			{
+				if (tDatums != nullptr)
+				{
+					for (const auto& datum : *tDatums)
+					{
+						spKeypointRing->push(datum, datum.inputTimestampNs);
+						const auto timestampNs = getTimestampNs();
+						if (datum.postProcessingTimestampNs > 0)
+							spStageStatistics->add(OPENPOSE_STAGE_OUTPUT, timestampNs - datum.postProcessingTimestampNs);
+						if (datum.inputTimestampNs > 0)
+							spStageStatistics->add(OPENPOSE_STAGE_TOTAL, timestampNs - datum.inputTimestampNs);
+					}
+				}
+			}
+			catch (const std::exception& e)
+			{
+				this->stop();
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+			}
+		}
+
+	private:
+		const std::shared_ptr<KeypointRing> spKeypointRing;
+		const std::shared_ptr<StageStatistics> spStageStatistics;
+
+		DELETE_COPY(WKeypointRing);
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_W_KEYPOINT_RING_HPP
@@ -0,0 +1,114 @@
+#ifndef OPENPOSE_EXAMPLES_DLL_EXPORT_W_LATEST_FRAME_INPUT_HPP
+#define OPENPOSE_EXAMPLES_DLL_EXPORT_W_LATEST_FRAME_INPUT_HPP
+
+// C++ std library dependencies
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+// OpenPose dependencies
+#include <openpose/headers.hpp>
+
+namespace dllExport
+{
+	/**
+	 * LatestFrameMailbox: single-slot mailbox between the host and the input worker. put() never waits: it replaces the
+	 * pending frame, if any, which is then dropped (and its host buffer released). So the pipeline always starts with the
+	 * newest frame, however long the previous one took. Only this mailbox overwrites: the queues between the later stages
+	 * still block.
+	 */
+	template<typename TDatums>
+	class LatestFrameMailbox
+	{
+	public:
+		LatestFrameMailbox() = default;
+
+		/**
+		 * @return Whether a pending frame was overwritten.
+		 */
+		bool put(TDatums tDatums)
+		{
+			try
+			{
+				TDatums overwrittenDatums;
+				{
+					const std::lock_guard<std::mutex> lock{mMutex};
+					overwrittenDatums = std::move(mTDatums);
+					mTDatums = std::move(tDatums);
+				}
+				mConditionVariable.notify_one();
+				// overwrittenDatums (and its host frame lease) is released here, outside the lock
+				return overwrittenDatums != nullptr;
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+				return false;
+			}
+		}
+
+		/**
+		 * @return The pending frame, or nullptr if none arrived within `timeout`.
+		 */
+		TDatums take(const std::chrono::milliseconds timeout)
+		{
+			try
+			{
+				std::unique_lock<std::mutex> lock{mMutex};
+				mConditionVariable.wait_for(lock, timeout, [this]{ return mTDatums != nullptr; });
+				return std::move(mTDatums);
+			}
+			catch (const std::exception& e)
+			{
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+				return nullptr;
+			}
+		}
+
+	private:
+		std::mutex mMutex;
+		std::condition_variable mConditionVariable;
+		TDatums mTDatums;
+
+		DELETE_COPY(LatestFrameMailbox);
+	};
+
+	/**
+	 * WLatestFrameInput: input worker that feeds the wrapper from a LatestFrameMailbox. It waits for a frame at most
+	 * a few milliseconds, so the wrapper threads can still be stopped while no frame arrives.
+	 */
+	template<typename TDatums>
+	class WLatestFrameInput : public op::WorkerProducer<TDatums>
+	{
+	public:
+		explicit WLatestFrameInput(const std::shared_ptr<LatestFrameMailbox<TDatums>>& latestFrameMailbox) :
+			spLatestFrameMailbox{latestFrameMailbox}
+		{
+		}
+
+		void initializationOnThread()
+		{
+		}
+
+		TDatums workProducer()
+		{
+			try
+			{
+				return spLatestFrameMailbox->take(std::chrono::milliseconds{10});
+			}
+			catch (const std::exception& e)
+			{
+				this->stop();
+				op::error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+				return nullptr;
+			}
+		}
+
+	private:
+		const std::shared_ptr<LatestFrameMailbox<TDatums>> spLatestFrameMailbox;
+
+		DELETE_COPY(WLatestFrameInput);
+	};
+}
+
+#endif // OPENPOSE_EXAMPLES_DLL_EXPORT_W_LATEST_FRAME_INPUT_HPP
@@ -17,6 +17,7 @@
 
 // C++ std library dependencies
 #include <chrono> // `std::chrono::` functions and classes, e.g. std::chrono::milliseconds
+#include <memory> // std::unique_ptr
 #include <thread> // std::this_thread
 // Other 3rdparty dependencies
 // GFlags: DEFINE_bool, _int32, _int64, _uint64, _double, _string
@@ -25,8 +26,18 @@
 #ifndef GFLAGS_GFLAGS_H_
 namespace gflags = google;
 #endif
+// OpenCV dependencies
+#include <opencv2/imgproc/imgproc.hpp> // cv::cvtColor
 // OpenPose dependencies
 #include <openpose/headers.hpp>
+// DLL dependencies
+#include "dllExportFile.hpp"
+#include "dllExport/batchExtractor.hpp"
+#include "dllExport/copyStatistics.hpp"
+#include "dllExport/frameBufferPool.hpp"
+#include "dllExport/int8Calibrator.hpp"
+#include "dllExport/session.hpp"
+#include "dllExport/sessionCache.hpp"
 
 // See all the available parameter options withe the `--help` flag. E.g. `build/examples/openpose/openpose.bin --help`
 // Note: This command will show you flags for other unnecessary 3rdparty files. Check only the flags for the OpenPose
@@ -63,7 +74,7 @@ DEFINE_string(model_folder, "Assets/Dependencies/models/", "Folder path (absolut
 DEFINE_string(output_resolution, "-1x-1", "The image resolution (display and output). Use \"-1x-1\" to force the program to use the"
 	" input image resolution.");
 DEFINE_int32(num_gpu, -1, "The number of GPU devices to use. If negative, it will use all the available GPUs in your"
-	" machine.");
+	" machine. On CPU_ONLY builds, it is the number of pose extractor workers (1 if negative).");
 DEFINE_int32(num_gpu_start, 0, "GPU device start number.");
 DEFINE_int32(keypoint_scale, 0, "Scaling of the (x,y) coordinates of the final pose data array, i.e. the scale of the (x,y)"
 	" coordinates that will be saved with the `write_keypoint` & `write_keypoint_json` flags."
@@ -96,6 +107,8 @@ DEFINE_bool(heatmaps_add_parts, false, "If true, it will add the body part heatm
 DEFINE_bool(heatmaps_add_bkg, false, "Same functionality as `add_heatmaps_parts`, but adding the heatmap corresponding to"
 	" background.");
 DEFINE_bool(heatmaps_add_PAFs, false, "Same functionality as `add_heatmaps_parts`, but adding the PAFs.");
+DEFINE_int32(heatmaps_scale, 2, "Set 0 to scale op::Datum::poseHeatMaps in the range [-1,1], 1 for [0,1]; 2 for integer"
+	" rounded [0,255].");
 // OpenPose Face
 DEFINE_bool(face, false, "Enables face keypoint detection. It will share some parameters from the body pose, e.g."
 	" `model_folder`. Note that this will considerable slow down the performance and increse"
@@ -134,7 +147,8 @@ DEFINE_double(render_threshold, 0.05, "Only estimated keypoints whose score conf
 DEFINE_int32(render_pose, 2, "Set to 0 for no rendering, 1 for CPU rendering (slightly faster), and 2 for GPU rendering"
 	" (slower but greater functionality, e.g. `alpha_X` flags). If rendering is enabled, it will"
 	" render both `outputData` and `cvOutputData` with the original image and desired body part"
-	" to be shown (i.e. keypoints, heat maps or PAFs).");
+	" to be shown (i.e. keypoints, heat maps or PAFs). On CPU_ONLY builds, GPU rendering falls back"
+	" to CPU rendering.");
 DEFINE_double(alpha_pose, 0.6, "Blending factor (range 0-1) for the body part rendering. 1 will show it completely, 0 will"
 	" hide it. Only valid for GPU rendering.");
 DEFINE_double(alpha_heatmap, 0.7, "Blending factor (range 0-1) between heatmap and original frame. 1 will only show the"
@@ -172,122 +186,723 @@ DEFINE_string(write_heatmaps, "", "Directory to write body pose heatmaps in *.pn
 	" must be enabled.");
 DEFINE_string(write_heatmaps_format, "png", "File extension and format for `write_heatmaps`, analogous to `write_images_format`."
 	" Recommended `png` or any compressed and lossless format.");
+// DLL export
+DEFINE_int32(keypoint_ring_max_people, 16, "Maximum number of people per frame kept for `openPoseSessionPollKeypoints`. Extra"
+	" people are dropped.");
+DEFINE_int32(session_cache_size, 1, "Number of destroyed push-input sessions kept running (with their networks loaded) so"
+	" that a new session with the same configuration starts instantly. 0 to disable it.");
+DEFINE_bool(latest_frame_only, false, "If enabled, every queue between the pipeline stages holds a single frame and a"
+	" pushed frame replaces the one waiting to enter the pipeline, so each frame enters the pipeline as the newest one. The"
+	" queues between the stages still block, so a slow stage does not skip the frames already in the pipeline."
+	" It keeps the multi-threaded throughput with a bounded latency, unlike `disable_multi_thread`.");
+DEFINE_bool(render_uint8, false, "If enabled, the keypoints are rendered on the CPU straight into the 8-bit output image,"
+	" skipping the float output image (and its 2 full-frame conversions) used by `render_pose`. Keypoints only, no"
+	" `alpha_X` blending nor heatmaps. It has no effect if `render_pose` is 0, nor on `openPoseDemo`.");
+DEFINE_int32(heatmaps_format, 0, "Storage of the heatmaps given to the host heatmap callback: 0 for float32, 1 for float16"
+	" and 2 for uint8 quantized over the `heatmaps_scale` range.");
+DEFINE_int32(batch_pose_engine, 0, "Body pose inference backend of `openPoseBatchCreate` only: 0 for Caffe, 1 for the OpenCV dnn module (CPU"
+	" only, OpenCV 3.3 or later), usually faster than Caffe on machines without GPU, and 2 for the same OpenCV engine"
+	" quantized to int8 (OpenCV 4.6 or later) from `int8_calibration_file`. Ignored by the sessions, which always use"
+	" Caffe.");
+DEFINE_string(int8_calibration_file, "", "Int8 calibration file written by `openPoseCalibrateInt8` (e.g."
+	" `pose_int8_calibration.yml`) and read by `batch_pose_engine` 2.");
+DEFINE_bool(batch_share_weights, false, "If enabled (Caffe `batch_pose_engine` only), the batch extractors of the process"
+	" with the same model and GPU load the caffemodel once and share it, each one keeping its own activations, so several"
+	" of them can run in parallel (e.g. one per CPU worker) without a copy of the weights each.");
 
 
-extern "C" {
-	__declspec(dllexport) int openPoseDemo()
+namespace
+{
+	void logException(const std::exception& e, const int line, const std::string& function, const std::string& file)
 	{
-		// logging_level
-		op::check(0 <= FLAGS_logging_level && FLAGS_logging_level <= 255, "Wrong logging_level value.",
+		op::log(std::string{"Error: "} + e.what(), op::Priority::Max, line, function, file);
+	}
+
+	std::string toString(const char* const text)
+	{
+		return (text == nullptr ? std::string{} : std::string{text});
+	}
+
+	std::string toResolution(const int width, const int height)
+	{
+		return std::to_string(width) + "x" + std::to_string(height);
+	}
+
+	void setLoggingLevel(const int loggingLevel)
+	{
+		op::check(0 <= loggingLevel && loggingLevel <= 255, "Wrong logging_level value.",
 			__LINE__, __FUNCTION__, __FILE__);
-		op::ConfigureLog::setPriorityThreshold((op::Priority)FLAGS_logging_level);
+		op::ConfigureLog::setPriorityThreshold((op::Priority)loggingLevel);
 		// op::ConfigureLog::setPriorityThreshold(op::Priority::None); // To print all logging messages
+	}
 
-		op::log("Starting pose estimation demo.", op::Priority::High);
-		const auto timerBegin = std::chrono::high_resolution_clock::now();
+	// It wraps (BGR24) or converts (BGRA32) a host frame into a BGR cv::Mat, which keeps pointing to `data` in the first
+	// case. It returns an empty cv::Mat if the arguments are not valid.
+	cv::Mat hostFrameToCvMat(const unsigned char* data, const int width, const int height, const int stepBytes,
+		const int pixelFormat)
+	{
+		if (data == nullptr || width <= 0 || height <= 0)
+			return cv::Mat{};
+		if (pixelFormat == OPENPOSE_PIXEL_FORMAT_BGR24 && stepBytes >= 3 * width)
+			// Zero-copy: the Mat header points to the host memory, which is only read by OpenPose
+			return cv::Mat(height, width, CV_8UC3, const_cast<unsigned char*>(data), (size_t)stepBytes);
+		if (pixelFormat == OPENPOSE_PIXEL_FORMAT_BGRA32 && stepBytes >= 4 * width)
+		{
+			// OpenPose works on 3-channel BGR frames, so BGRA is converted in a single pass
+			const cv::Mat hostFrame(height, width, CV_8UC4, const_cast<unsigned char*>(data), (size_t)stepBytes);
+			cv::Mat cvMat;
+			cvMat.allocator = &dllExport::FrameBufferPool::getInstance();
+			cv::cvtColor(hostFrame, cvMat, cv::COLOR_BGRA2BGR);
+			return cvMat;
+		}
+		return cv::Mat{};
+	}
 
-		// Applying user defined configuration - Google flags to program variables
-		// outputSize
+	// Applying user defined configuration - Google flags to the C configuration struct
+	// The strings point to the flag values, so `config` must not outlive them (they are global)
+	void getConfigFromFlags(OpenPoseConfig& config)
+	{
+		// Producer
+		config.inputMode = OPENPOSE_INPUT_PRODUCER;
+		config.imageDirectory = FLAGS_image_dir.c_str();
+		config.video = FLAGS_video.c_str();
+		config.ipCamera = FLAGS_ip_camera.c_str();
+		config.camera = FLAGS_camera;
+		const auto cameraResolution = op::flagsToPoint(FLAGS_camera_resolution, "1280x720");
+		config.cameraWidth = cameraResolution.x;
+		config.cameraHeight = cameraResolution.y;
+		config.cameraFps = FLAGS_camera_fps;
+		config.frameFirst = FLAGS_frame_first;
+		config.frameLast = FLAGS_frame_last;
+		config.processRealTime = FLAGS_process_real_time;
+		config.frameFlip = FLAGS_frame_flip;
+		config.frameRotate = FLAGS_frame_rotate;
+		config.framesRepeat = FLAGS_frames_repeat;
+		// OpenPose
+		config.modelFolder = FLAGS_model_folder.c_str();
 		const auto outputSize = op::flagsToPoint(FLAGS_output_resolution, "-1x-1");
-		// netInputSize
+		config.outputWidth = outputSize.x;
+		config.outputHeight = outputSize.y;
+		config.numGpu = FLAGS_num_gpu;
+		config.numGpuStart = FLAGS_num_gpu_start;
+		config.keypointScale = FLAGS_keypoint_scale;
+		config.identification = FLAGS_identification;
+		// OpenPose Body Pose
+		config.bodyEnable = !FLAGS_body_disable;
+		config.modelPose = FLAGS_model_pose.c_str();
 		const auto netInputSize = op::flagsToPoint(FLAGS_net_resolution, "-1x368");
-		// faceNetInputSize
+		config.netInputWidth = netInputSize.x;
+		config.netInputHeight = netInputSize.y;
+		config.scaleNumber = FLAGS_scale_number;
+		config.scaleGap = FLAGS_scale_gap;
+		config.heatmapsAddParts = FLAGS_heatmaps_add_parts;
+		config.heatmapsAddBkg = FLAGS_heatmaps_add_bkg;
+		config.heatmapsAddPAFs = FLAGS_heatmaps_add_PAFs;
+		config.heatmapsScale = FLAGS_heatmaps_scale;
+		config.batchPoseEngine = FLAGS_batch_pose_engine;
+		config.int8CalibrationFile = FLAGS_int8_calibration_file.c_str();
+		config.batchShareWeights = FLAGS_batch_share_weights;
+		// OpenPose Face
+		config.faceEnable = FLAGS_face;
 		const auto faceNetInputSize = op::flagsToPoint(FLAGS_face_net_resolution, "368x368 (multiples of 16)");
-		// handNetInputSize
+		config.faceNetInputWidth = faceNetInputSize.x;
+		config.faceNetInputHeight = faceNetInputSize.y;
+		// OpenPose Hand
+		config.handEnable = FLAGS_hand;
 		const auto handNetInputSize = op::flagsToPoint(FLAGS_hand_net_resolution, "368x368 (multiples of 16)");
+		config.handNetInputWidth = handNetInputSize.x;
+		config.handNetInputHeight = handNetInputSize.y;
+		config.handScaleNumber = FLAGS_hand_scale_number;
+		config.handScaleRange = FLAGS_hand_scale_range;
+		config.handTracking = FLAGS_hand_tracking;
+		// OpenPose Rendering
+		config.partToShow = FLAGS_part_to_show;
+		config.disableBlending = FLAGS_disable_blending;
+		// OpenPose Rendering Pose
+		config.renderThreshold = FLAGS_render_threshold;
+		config.renderPose = FLAGS_render_pose;
+		config.alphaPose = FLAGS_alpha_pose;
+		config.alphaHeatmap = FLAGS_alpha_heatmap;
+		// OpenPose Rendering Face
+		config.faceRenderThreshold = FLAGS_face_render_threshold;
+		config.faceRender = FLAGS_face_render;
+		config.faceAlphaPose = FLAGS_face_alpha_pose;
+		config.faceAlphaHeatmap = FLAGS_face_alpha_heatmap;
+		// OpenPose Rendering Hand
+		config.handRenderThreshold = FLAGS_hand_render_threshold;
+		config.handRender = FLAGS_hand_render;
+		config.handAlphaPose = FLAGS_hand_alpha_pose;
+		config.handAlphaHeatmap = FLAGS_hand_alpha_heatmap;
+		config.renderUint8 = FLAGS_render_uint8;
+		// Display
+		config.fullscreen = FLAGS_fullscreen;
+		config.guiVerbose = !FLAGS_no_gui_verbose;
+		config.display = !FLAGS_no_display;
+		// Result Saving
+		config.writeImages = FLAGS_write_images.c_str();
+		config.writeImagesFormat = FLAGS_write_images_format.c_str();
+		config.writeVideo = FLAGS_write_video.c_str();
+		config.writeKeypoint = FLAGS_write_keypoint.c_str();
+		config.writeKeypointFormat = FLAGS_write_keypoint_format.c_str();
+		config.writeKeypointJson = FLAGS_write_keypoint_json.c_str();
+		config.writeCocoJson = FLAGS_write_coco_json.c_str();
+		config.writeHeatmaps = FLAGS_write_heatmaps.c_str();
+		config.writeHeatmapsFormat = FLAGS_write_heatmaps_format.c_str();
+		// Session
+		config.disableMultiThread = FLAGS_disable_multi_thread;
+		config.latestFrameOnly = FLAGS_latest_frame_only;
+		config.keypointRingMaxPeople = FLAGS_keypoint_ring_max_people;
+		config.sessionCacheSize = FLAGS_session_cache_size;
+		config.keypointCallback = nullptr;
+		config.keypointCallbackUserData = nullptr;
+		config.heatmapCallback = nullptr;
+		config.heatmapCallbackUserData = nullptr;
+		config.heatmapFormat = FLAGS_heatmaps_format;
+	}
+
+	op::ScaleMode toHeatMapScale(const int heatmapsScale)
+	{
+		if (heatmapsScale == 0)
+			return op::ScaleMode::PlusMinusOne;
+		else if (heatmapsScale == 1)
+			return op::ScaleMode::ZeroToOne;
+		else if (heatmapsScale == 2)
+			return op::ScaleMode::UnsignedChar;
+		op::error("Integer does not correspond to any heatmaps scale mode: (0, 1, 2) for ([-1,1], [0,1], [0,255]).",
+			__LINE__, __FUNCTION__, __FILE__);
+		return op::ScaleMode::UnsignedChar;
+	}
+
+	// CPU_ONLY builds have no GPU renderers nor devices to enumerate: GPU rendering falls back to CPU rendering and
+	// `numGpu` is the number of CPU workers
+	op::RenderMode toRenderMode(const int renderFlag, const int renderPoseFlag = -2)
+	{
+		const auto renderMode = op::flagsToRenderMode(renderFlag, renderPoseFlag);
+		#ifndef USE_CUDA
+			if (renderMode == op::RenderMode::Gpu)
+				return op::RenderMode::Cpu;
+		#endif
+		return renderMode;
+	}
+
+	int toNumberGpus(const int numGpu)
+	{
+		#ifndef USE_CUDA
+			if (numGpu < 0)
+				return 1;
+		#endif
+		return numGpu;
+	}
+
+	// C configuration struct to program variables. It does not touch any global state, so each session can have its own
+	// configuration.
+	dllExport::SessionConfiguration getSessionConfiguration(const OpenPoseConfig& config)
+	{
+		if (config.inputMode != OPENPOSE_INPUT_PRODUCER && config.inputMode != OPENPOSE_INPUT_PUSH)
+			op::error("Unknown inputMode.", __LINE__, __FUNCTION__, __FILE__);
+		const auto pushInput = (config.inputMode == OPENPOSE_INPUT_PUSH);
 		// producerType
-		const auto producerSharedPtr = op::flagsToProducer(FLAGS_image_dir, FLAGS_video, FLAGS_ip_camera, FLAGS_camera,
-			FLAGS_camera_resolution, FLAGS_camera_fps);
+		const auto producerSharedPtr = (pushInput
+			? nullptr
+			: op::flagsToProducer(toString(config.imageDirectory), toString(config.video), toString(config.ipCamera),
+				config.camera, toResolution(config.cameraWidth, config.cameraHeight), config.cameraFps));
 		// poseModel
-		const auto poseModel = op::flagsToPoseModel(FLAGS_model_pose);
+		const auto poseModel = op::flagsToPoseModel(toString(config.modelPose));
 		// keypointScale
-		const auto keypointScale = op::flagsToScaleMode(FLAGS_keypoint_scale);
+		const auto keypointScale = op::flagsToScaleMode(config.keypointScale);
 		// heatmaps to add
-		const auto heatMapTypes = op::flagsToHeatMaps(FLAGS_heatmaps_add_parts, FLAGS_heatmaps_add_bkg,
-			FLAGS_heatmaps_add_PAFs);
+		const auto heatMapTypes = op::flagsToHeatMaps(config.heatmapsAddParts != 0, config.heatmapsAddBkg != 0,
+			config.heatmapsAddPAFs != 0);
 		// Enabling Google Logging
 		const bool enableGoogleLogging = true;
 		// Logging
 		op::log("", op::Priority::Low, __LINE__, __FUNCTION__, __FILE__);
 
-		// OpenPose wrapper
-		op::log("Configuring OpenPose wrapper.", op::Priority::Low, __LINE__, __FUNCTION__, __FILE__);
-		op::Wrapper<std::vector<op::Datum>> opWrapper;
 		// Pose configuration (use WrapperStructPose{} for default and recommended configuration)
-		const op::WrapperStructPose wrapperStructPose{ !FLAGS_body_disable, netInputSize, outputSize, keypointScale,
-			FLAGS_num_gpu, FLAGS_num_gpu_start, FLAGS_scale_number,
-			(float)FLAGS_scale_gap, op::flagsToRenderMode(FLAGS_render_pose),
-			poseModel, !FLAGS_disable_blending, (float)FLAGS_alpha_pose,
-			(float)FLAGS_alpha_heatmap, FLAGS_part_to_show, FLAGS_model_folder,
-			heatMapTypes, op::ScaleMode::UnsignedChar,
-			(float)FLAGS_render_threshold, enableGoogleLogging,
-			FLAGS_identification };
+		const op::WrapperStructPose wrapperStructPose{ config.bodyEnable != 0,
+			op::Point<int>{config.netInputWidth, config.netInputHeight},
+			op::Point<int>{config.outputWidth, config.outputHeight}, keypointScale,
+			toNumberGpus(config.numGpu), config.numGpuStart, config.scaleNumber,
+			(float)config.scaleGap, toRenderMode(config.renderPose),
+			poseModel, config.disableBlending == 0, (float)config.alphaPose,
+			(float)config.alphaHeatmap, config.partToShow, toString(config.modelFolder),
+			heatMapTypes, toHeatMapScale(config.heatmapsScale),
+			(float)config.renderThreshold, enableGoogleLogging,
+			config.identification != 0 };
 		// Face configuration (use op::WrapperStructFace{} to disable it)
-		const op::WrapperStructFace wrapperStructFace{ FLAGS_face, faceNetInputSize,
-			op::flagsToRenderMode(FLAGS_face_render, FLAGS_render_pose),
-			(float)FLAGS_face_alpha_pose, (float)FLAGS_face_alpha_heatmap,
-			(float)FLAGS_face_render_threshold };
+		const op::WrapperStructFace wrapperStructFace{ config.faceEnable != 0,
+			op::Point<int>{config.faceNetInputWidth, config.faceNetInputHeight},
+			toRenderMode(config.faceRender, config.renderPose),
+			(float)config.faceAlphaPose, (float)config.faceAlphaHeatmap,
+			(float)config.faceRenderThreshold };
 		// Hand configuration (use op::WrapperStructHand{} to disable it)
-		const op::WrapperStructHand wrapperStructHand{ FLAGS_hand, handNetInputSize, FLAGS_hand_scale_number,
-			(float)FLAGS_hand_scale_range, FLAGS_hand_tracking,
-			op::flagsToRenderMode(FLAGS_hand_render, FLAGS_render_pose),
-			(float)FLAGS_hand_alpha_pose, (float)FLAGS_hand_alpha_heatmap,
-			(float)FLAGS_hand_render_threshold };
+		const op::WrapperStructHand wrapperStructHand{ config.handEnable != 0,
+			op::Point<int>{config.handNetInputWidth, config.handNetInputHeight}, config.handScaleNumber,
+			(float)config.handScaleRange, config.handTracking != 0,
+			toRenderMode(config.handRender, config.renderPose),
+			(float)config.handAlphaPose, (float)config.handAlphaHeatmap,
+			(float)config.handRenderThreshold };
 		// Producer (use default to disable any input)
-		const op::WrapperStructInput wrapperStructInput{ producerSharedPtr, FLAGS_frame_first, FLAGS_frame_last,
-			FLAGS_process_real_time, FLAGS_frame_flip, FLAGS_frame_rotate,
-			FLAGS_frames_repeat };
+		const op::WrapperStructInput wrapperStructInput{ producerSharedPtr, config.frameFirst, config.frameLast,
+			config.processRealTime != 0, config.frameFlip != 0, config.frameRotate,
+			config.framesRepeat != 0 };
 		// Consumer (comment or use default argument to disable any output)
-		const op::WrapperStructOutput wrapperStructOutput{ !FLAGS_no_display, !FLAGS_no_gui_verbose, FLAGS_fullscreen,
-			FLAGS_write_keypoint,
-			op::stringToDataFormat(FLAGS_write_keypoint_format),
-			FLAGS_write_keypoint_json, FLAGS_write_coco_json,
-			FLAGS_write_images, FLAGS_write_images_format, FLAGS_write_video,
-			FLAGS_write_heatmaps, FLAGS_write_heatmaps_format };
-		// Configure wrapper
-		opWrapper.configure(wrapperStructPose, wrapperStructFace, wrapperStructHand, wrapperStructInput,
-			wrapperStructOutput);
-		// Set to single-thread running (to debug and/or reduce latency)
-		if (FLAGS_disable_multi_thread)
-			opWrapper.disableMultiThreading();
-
-		// Start processing
-		// Two different ways of running the program on multithread environment
-		op::log("Starting thread(s)", op::Priority::High);
-		// Option a) Recommended - Also using the main thread (this thread) for processing (it saves 1 thread)
-		// Start, run & stop threads
-		opWrapper.exec();  // It blocks this thread until all threads have finished
-
-						   // // Option b) Keeping this thread free in case you want to do something else meanwhile, e.g. profiling the GPU
-						   // memory
-						   // // VERY IMPORTANT NOTE: if OpenCV is compiled with Qt support, this option will not work. Qt needs the main
-						   // // thread to plot visual results, so the final GUI (which uses OpenCV) would return an exception similar to:
-						   // // `QMetaMethod::invoke: Unable to invoke methods with return values in queued connections`
-						   // // Start threads
-						   // opWrapper.start();
-						   // // Profile used GPU memory
-						   //     // 1: wait ~10sec so the memory has been totally loaded on GPU
-						   //     // 2: profile the GPU memory
-						   // const auto sleepTimeMs = 10;
-						   // for (auto i = 0 ; i < 10000/sleepTimeMs && opWrapper.isRunning() ; i++)
-						   //     std::this_thread::sleep_for(std::chrono::milliseconds{sleepTimeMs});
-						   // op::Profiler::profileGpuMemory(__LINE__, __FUNCTION__, __FILE__);
-						   // // Keep program alive while running threads
-						   // while (opWrapper.isRunning())
-						   //     std::this_thread::sleep_for(std::chrono::milliseconds{sleepTimeMs});
-						   // // Stop and join threads
-						   // op::log("Stopping thread(s)", op::Priority::High);
-						   // opWrapper.stop();
-
-						   // Measuring total time
-		const auto now = std::chrono::high_resolution_clock::now();
-		const auto totalTimeSec = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(now - timerBegin).count()
-			* 1e-9;
-		const auto message = "Real-time pose estimation demo successfully finished. Total time: "
-			+ std::to_string(totalTimeSec) + " seconds.";
-		op::log(message, op::Priority::High);
+		// The host callbacks replace the display and the writers
+		const op::WrapperStructOutput wrapperStructOutput = (config.keypointCallback != nullptr
+			|| config.heatmapCallback != nullptr
+			? op::WrapperStructOutput{}
+			: op::WrapperStructOutput{ config.display != 0, config.guiVerbose != 0,
+				config.fullscreen != 0,
+				toString(config.writeKeypoint),
+				op::stringToDataFormat(toString(config.writeKeypointFormat)),
+				toString(config.writeKeypointJson), toString(config.writeCocoJson),
+				toString(config.writeImages), toString(config.writeImagesFormat), toString(config.writeVideo),
+				toString(config.writeHeatmaps), toString(config.writeHeatmapsFormat) });
+		return dllExport::SessionConfiguration{ wrapperStructPose, wrapperStructFace, wrapperStructHand,
+			wrapperStructInput, wrapperStructOutput, config.disableMultiThread != 0, pushInput,
+			config.latestFrameOnly != 0, config.keypointRingMaxPeople, config.keypointCallback, config.keypointCallbackUserData,
+			config.renderUint8 != 0, config.heatmapCallback, config.heatmapCallbackUserData, config.heatmapFormat };
+	}
 
-		return 0;
+	dllExport::BatchConfiguration getBatchConfiguration(const OpenPoseConfig& config)
+	{
+		return dllExport::BatchConfiguration{ op::flagsToPoseModel(toString(config.modelPose)),
+			toString(config.modelFolder), config.numGpuStart,
+			op::Point<int>{config.netInputWidth, config.netInputHeight},
+			op::Point<int>{config.outputWidth, config.outputHeight}, config.scaleNumber, config.scaleGap,
+			op::flagsToScaleMode(config.keypointScale), (OpenPosePoseEngine)config.batchPoseEngine,
+			toString(config.int8CalibrationFile), config.batchShareWeights != 0 };
+	}
+}
+
+// Owner of a dllExport::BatchExtractor behind the opaque C handle
+struct OpenPoseBatch
+{
+	std::unique_ptr<dllExport::BatchExtractor> upBatchExtractor;
+};
+
+// Owner of a dllExport::Session behind the opaque C handle
+struct OpenPoseSession
+{
+	std::shared_ptr<dllExport::Session> spSession;
+	// Non-empty if the session can be returned to the dllExport::SessionCache when destroyed, which then keeps up to
+	// sessionCacheSize idle sessions
+	std::string cacheKey;
+	int sessionCacheSize = 0;
+};
+
+extern "C" {
+	OP_DLL_EXPORT int openPoseDemo()
+	{
+		try
+		{
+			// logging_level
+			setLoggingLevel(FLAGS_logging_level);
+
+			op::log("Starting pose estimation demo.", op::Priority::High);
+			const auto timerBegin = std::chrono::high_resolution_clock::now();
+
+			OpenPoseConfig config;
+			getConfigFromFlags(config);
+			const auto sessionConfiguration = getSessionConfiguration(config);
+
+			// OpenPose wrapper
+			op::log("Configuring OpenPose wrapper.", op::Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+			op::Wrapper<std::vector<op::Datum>> opWrapper;
+			// Configure wrapper
+			opWrapper.configure(sessionConfiguration.pose, sessionConfiguration.face, sessionConfiguration.hand,
+				sessionConfiguration.input, sessionConfiguration.output);
+			// Set to single-thread running (to debug and/or reduce latency)
+			if (sessionConfiguration.disableMultiThreading)
+				opWrapper.disableMultiThreading();
+
+			// Start processing
+			op::log("Starting thread(s)", op::Priority::High);
+			// Also using the main thread (this thread) for processing (it saves 1 thread)
+			// Start, run & stop threads
+			opWrapper.exec();  // It blocks this thread until all threads have finished
+			// See openPoseSession* for the alternative that keeps the calling thread free (opWrapper.start())
+
+			// Measuring total time
+			const auto now = std::chrono::high_resolution_clock::now();
+			const auto totalTimeSec = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(now - timerBegin).count()
+				* 1e-9;
+			const auto message = "Real-time pose estimation demo successfully finished. Total time: "
+				+ std::to_string(totalTimeSec) + " seconds.";
+			op::log(message, op::Priority::High);
+
+			return OPENPOSE_OK;
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+			return OPENPOSE_ERROR;
+		}
+	}
+
+	OP_DLL_EXPORT int openPoseConfigDefault(OpenPoseConfig* config)
+	{
+		try
+		{
+			if (config == nullptr)
+				return OPENPOSE_INVALID_ARGUMENT;
+			getConfigFromFlags(*config);
+			return OPENPOSE_OK;
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+			return OPENPOSE_ERROR;
+		}
+	}
+
+	OP_DLL_EXPORT int openPoseSetLoggingLevel(int loggingLevel)
+	{
+		try
+		{
+			setLoggingLevel(loggingLevel);
+			return OPENPOSE_OK;
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+			return OPENPOSE_ERROR;
+		}
+	}
+
+	OP_DLL_EXPORT OpenPoseSession* openPoseSessionCreateWithConfig(const OpenPoseConfig* config)
+	{
+		try
+		{
+			if (config == nullptr)
+				return nullptr;
+			op::log("Configuring OpenPose session.", op::Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+			if (config->batchPoseEngine != OPENPOSE_POSE_ENGINE_CAFFE)
+				op::log("`batchPoseEngine` only applies to openPoseBatchCreate, sessions use Caffe.", op::Priority::High,
+					__LINE__, __FUNCTION__, __FILE__);
+			const auto sessionConfiguration = getSessionConfiguration(*config);
+			std::unique_ptr<OpenPoseSession> upOpenPoseSession{new OpenPoseSession};
+			// Only push-input sessions can be reused, producers cannot be rewound
+			if (sessionConfiguration.pushInput)
+			{
+				upOpenPoseSession->cacheKey = dllExport::getSessionCacheKey(sessionConfiguration);
+				upOpenPoseSession->sessionCacheSize = config->sessionCacheSize;
+				upOpenPoseSession->spSession = dllExport::SessionCache::getInstance().acquire(
+					upOpenPoseSession->cacheKey);
+			}
+			if (upOpenPoseSession->spSession != nullptr)
+				upOpenPoseSession->spSession->resetOwner();
+			else
+				upOpenPoseSession->spSession = std::make_shared<dllExport::Session>(sessionConfiguration);
+			return upOpenPoseSession.release();
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+			return nullptr;
+		}
+	}
+
+	OP_DLL_EXPORT OpenPoseSession* openPoseSessionCreate()
+	{
+		try
+		{
+			setLoggingLevel(FLAGS_logging_level);
+			OpenPoseConfig config;
+			getConfigFromFlags(config);
+			return openPoseSessionCreateWithConfig(&config);
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+			return nullptr;
+		}
+	}
+
+	OP_DLL_EXPORT OpenPoseSession* openPoseSessionCreatePushInput()
+	{
+		try
+		{
+			setLoggingLevel(FLAGS_logging_level);
+			OpenPoseConfig config;
+			getConfigFromFlags(config);
+			config.inputMode = OPENPOSE_INPUT_PUSH;
+			return openPoseSessionCreateWithConfig(&config);
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+			return nullptr;
+		}
+	}
+
+	OP_DLL_EXPORT int openPoseSessionStart(OpenPoseSession* session)
+	{
+		try
+		{
+			if (session == nullptr)
+				return OPENPOSE_INVALID_ARGUMENT;
+			session->spSession->start();
+			return OPENPOSE_OK;
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+			return OPENPOSE_ERROR;
+		}
+	}
+
+	OP_DLL_EXPORT int openPoseSessionIsRunning(const OpenPoseSession* session)
+	{
+		try
+		{
+			if (session == nullptr)
+				return OPENPOSE_INVALID_ARGUMENT;
+			return (session->spSession->isRunning() ? 1 : 0);
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+			return OPENPOSE_ERROR;
+		}
+	}
+
+	OP_DLL_EXPORT int openPoseSessionPushFrame(OpenPoseSession* session, const unsigned char* data, int width, int height,
+		int stepBytes, int pixelFormat, OpenPoseFrameReleaseCallback release, void* userData)
+	{
+		const auto beginNs = dllExport::getTimestampNs();
+		// Created first, so `release` is called exactly once whatever happens below
+		auto spHostFrameLease = std::make_shared<dllExport::HostFrameLease>(release, userData);
+		try
+		{
+			if (session == nullptr)
+				return OPENPOSE_INVALID_ARGUMENT;
+			const auto cvInputData = hostFrameToCvMat(data, width, height, stepBytes, pixelFormat);
+			if (cvInputData.empty())
+				return OPENPOSE_INVALID_ARGUMENT;
+			// Converted frames do not need the host buffer anymore, so it is released right away
+			if (cvInputData.data != data)
+				spHostFrameLease.reset();
+			const auto status = session->spSession->pushFrame(cvInputData, std::move(spHostFrameLease));
+			session->spSession->getStageStatistics().add(OPENPOSE_STAGE_PRODUCER, dllExport::getTimestampNs() - beginNs);
+			return status;
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+			return OPENPOSE_ERROR;
+		}
+	}
+
+	OP_DLL_EXPORT int openPoseSessionPollKeypoints(const OpenPoseSession* session, OpenPoseKeypointFrame* frame)
+	{
+		try
+		{
+			if (session == nullptr || frame == nullptr || frame->maxPeople < 0)
+				return OPENPOSE_INVALID_ARGUMENT;
+			return (session->spSession->pollKeypoints(*frame) ? 1 : 0);
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+			return OPENPOSE_ERROR;
+		}
+	}
+
+	OP_DLL_EXPORT OpenPoseBatch* openPoseBatchCreate(const OpenPoseConfig* config)
+	{
+		try
+		{
+			if (config == nullptr)
+				return nullptr;
+			op::log("Configuring OpenPose batch extractor.", op::Priority::Low, __LINE__, __FUNCTION__, __FILE__);
+			std::unique_ptr<OpenPoseBatch> upOpenPoseBatch{new OpenPoseBatch};
+			upOpenPoseBatch->upBatchExtractor.reset(new dllExport::BatchExtractor{getBatchConfiguration(*config)});
+			return upOpenPoseBatch.release();
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+			return nullptr;
+		}
+	}
+
+	OP_DLL_EXPORT int openPoseBatchProcess(OpenPoseBatch* batch, const OpenPoseImage* images, int numberImages,
+		OpenPoseKeypointFrame* frames)
+	{
+		try
+		{
+			if (batch == nullptr || numberImages < 0 || (numberImages > 0 && (images == nullptr || frames == nullptr)))
+				return OPENPOSE_INVALID_ARGUMENT;
+			// Called on this thread while the engine thread processes the previous image
+			const auto imageLoader = [images](const int index)
+			{
+				const auto& image = images[index];
+				if (image.path != nullptr)
+					return op::loadImage(image.path, cv::IMREAD_COLOR);
+				return hostFrameToCvMat(image.data, image.width, image.height, image.stepBytes, image.pixelFormat);
+			};
+			return batch->upBatchExtractor->process(numberImages, imageLoader, frames);
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+			return OPENPOSE_ERROR;
+		}
+	}
+
+	OP_DLL_EXPORT void openPoseBatchDestroy(OpenPoseBatch* batch)
+	{
+		try
+		{
+			delete batch;
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+		}
+	}
+
+	OP_DLL_EXPORT int openPoseCalibrateInt8(const OpenPoseConfig* config, OpenPoseInt8Report* report)
+	{
+		try
+		{
+			if (config == nullptr || report == nullptr || toString(config->imageDirectory).empty()
+				|| toString(config->int8CalibrationFile).empty())
+				return OPENPOSE_INVALID_ARGUMENT;
+			op::log("Calibrating the int8 pose engine.", op::Priority::High, __LINE__, __FUNCTION__, __FILE__);
+			*report = dllExport::calibrateInt8(op::flagsToPoseModel(toString(config->modelPose)),
+				toString(config->modelFolder), op::Point<int>{config->netInputWidth, config->netInputHeight},
+				toString(config->imageDirectory), toString(config->int8CalibrationFile), (float)config->renderThreshold);
+			return OPENPOSE_OK;
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+			return OPENPOSE_ERROR;
+		}
+	}
+
+	OP_DLL_EXPORT int openPoseSessionGetStageStats(const OpenPoseSession* session, int stage,
+		OpenPoseStageStats* stageStats)
+	{
+		try
+		{
+			if (session == nullptr || stageStats == nullptr || stage < 0 || stage >= OPENPOSE_STAGE_COUNT)
+				return OPENPOSE_INVALID_ARGUMENT;
+			*stageStats = session->spSession->getStageStatistics().get(stage);
+			return OPENPOSE_OK;
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+			return OPENPOSE_ERROR;
+		}
+	}
+
+	OP_DLL_EXPORT int openPoseBatchGetStageStats(const OpenPoseBatch* batch, int stage, OpenPoseStageStats* stageStats)
+	{
+		try
+		{
+			if (batch == nullptr || stageStats == nullptr || stage < 0 || stage >= OPENPOSE_STAGE_COUNT)
+				return OPENPOSE_INVALID_ARGUMENT;
+			*stageStats = batch->upBatchExtractor->getStageStatistics().get(stage);
+			return OPENPOSE_OK;
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+			return OPENPOSE_ERROR;
+		}
+	}
+
+	OP_DLL_EXPORT int openPoseGetBufferPoolStats(OpenPoseBufferPoolStats* bufferPoolStats)
+	{
+		try
+		{
+			if (bufferPoolStats == nullptr)
+				return OPENPOSE_INVALID_ARGUMENT;
+			const auto& frameBufferPool = dllExport::FrameBufferPool::getInstance();
+			bufferPoolStats->hits = frameBufferPool.getNumberHits();
+			bufferPoolStats->misses = frameBufferPool.getNumberMisses();
+			bufferPoolStats->idleBytes = frameBufferPool.getNumberIdleBytes();
+			return OPENPOSE_OK;
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+			return OPENPOSE_ERROR;
+		}
+	}
+
+	OP_DLL_EXPORT int openPoseGetCopyStats(OpenPoseCopyStats* copyStats)
+	{
+		try
+		{
+			if (copyStats == nullptr)
+				return OPENPOSE_INVALID_ARGUMENT;
+			const auto& copyStatistics = dllExport::CopyStatistics::getInstance();
+			copyStats->datumCopies = copyStatistics.getNumberDatumCopies();
+			copyStats->payloadCopies = copyStatistics.getNumberPayloadCopies();
+			copyStats->payloadBytes = copyStatistics.getNumberPayloadBytes();
+			return OPENPOSE_OK;
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+			return OPENPOSE_ERROR;
+		}
+	}
+
+	OP_DLL_EXPORT void openPoseReleaseCachedSessions()
+	{
+		try
+		{
+			dllExport::SessionCache::getInstance().clear();
+			// After the sessions, which hold pooled frames
+			dllExport::FrameBufferPool::getInstance().clear();
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+		}
+	}
+
+	OP_DLL_EXPORT int openPoseSessionStop(OpenPoseSession* session)
+	{
+		try
+		{
+			if (session == nullptr)
+				return OPENPOSE_INVALID_ARGUMENT;
+			session->spSession->stop();
+			return OPENPOSE_OK;
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+			return OPENPOSE_ERROR;
+		}
+	}
+
+	OP_DLL_EXPORT void openPoseSessionDestroy(OpenPoseSession* session)
+	{
+		try
+		{
+			if (session != nullptr && !session->cacheKey.empty())
+			{
+				// The host may free its frames once this returns, so none of them can still be in the pipeline when
+				// the session is parked for another user. A session that stopped meanwhile is not parked (see
+				// SessionCache::release), and destroying it releases its frames
+				session->spSession->waitForHostFrames();
+				dllExport::SessionCache::getInstance().release(session->cacheKey, std::move(session->spSession),
+					session->sessionCacheSize);
+			}
+			delete session;
+		}
+		catch (const std::exception& e)
+		{
+			logException(e, __LINE__, __FUNCTION__, __FILE__);
+		}
 	}
 }
 
@@ -0,0 +1,400 @@
+#ifndef OPENPOSE_EXAMPLES_TUTORIAL_POSE_DLL_EXPORT_FILE_HPP
+#define OPENPOSE_EXAMPLES_TUTORIAL_POSE_DLL_EXPORT_FILE_HPP
+
+// C ABI exported by `dllExportFile.cpp`.
+// None of these functions throws: errors are logged with op::log and reported with a negative OpenPoseStatus (or a
+// null pointer for the functions returning a handle).
+
+#ifdef _WIN32
+	#define OP_DLL_EXPORT __declspec(dllexport)
+#else
+	#define OP_DLL_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	typedef enum OpenPoseStatus
+	{
+		OPENPOSE_OK = 0,
+		OPENPOSE_FRAME_DROPPED = 1,
+		OPENPOSE_FRAME_REPLACED = 2,
+		OPENPOSE_ERROR = -1,
+		OPENPOSE_INVALID_ARGUMENT = -2,
+	} OpenPoseStatus;
+
+	// Opaque handle to one OpenPose pipeline (an op::Wrapper and its worker threads)
+	typedef struct OpenPoseSession OpenPoseSession;
+
+	// Layouts accepted by openPoseSessionPushFrame (8 bits per channel, interleaved)
+	typedef enum OpenPosePixelFormat
+	{
+		OPENPOSE_PIXEL_FORMAT_BGR24 = 0,
+		OPENPOSE_PIXEL_FORMAT_BGRA32 = 1,
+	} OpenPosePixelFormat;
+
+	// Called once OpenPose no longer reads a pushed frame buffer
+	typedef void (*OpenPoseFrameReleaseCallback)(void* userData);
+
+	// Keypoints of one processed frame, as filled by openPoseSessionPollKeypoints.
+	// The arrays are allocated by the host, with room for `maxPeople` people each, and any of them can be null to skip it.
+	// Layout: poseKeypoints [maxPeople][numberBodyParts][x, y, score], faceKeypoints [maxPeople][numberFaceParts][3],
+	// handKeypoints [left, right][maxPeople][numberHandParts][3] (i.e. the right hands start at maxPeople*21*3).
+	// Coordinates follow the `keypoint_scale` flag.
+	typedef struct OpenPoseKeypointFrame
+	{
+		// Filled by OpenPose
+		unsigned long long frameId;
+		long long timestampNs; // std::chrono::steady_clock time at which the output stage published the frame
+		long long inputTimestampNs; // Same clock, time at which the frame was pushed (0 for producer frames)
+		int numberPeople; // At most maxPeople. Arrays with fewer people (e.g. body disabled) have zero rows after theirs
+		int numberBodyParts;
+		int numberFaceParts; // 0 if face is disabled
+		int numberHandParts; // 0 if hand is disabled
+		// Filled by the host
+		float* poseKeypoints;
+		float* faceKeypoints;
+		float* handKeypoints;
+		int maxPeople;
+	} OpenPoseKeypointFrame;
+
+	// Called with the keypoints of each processed frame, see OpenPoseConfig::keypointCallback. `frame` and its arrays
+	// are only valid during the call
+	typedef void (*OpenPoseKeypointCallback)(const OpenPoseKeypointFrame* frame, void* userData);
+
+	// Storage of the heat maps given to OpenPoseHeatmapCallback
+	typedef enum OpenPoseHeatmapFormat
+	{
+		OPENPOSE_HEATMAP_FLOAT32 = 0,
+		OPENPOSE_HEATMAP_FLOAT16 = 1, // IEEE 754 half precision
+		OPENPOSE_HEATMAP_UINT8 = 2, // Quantized: value = data * quantizationScale + quantizationOffset
+	} OpenPoseHeatmapFormat;
+
+	// Body pose heat maps of one frame (op::Datum::poseHeatMaps): `numberChannels` planes of `height` x `width` values,
+	// in the channel order of the `heatmapsAdd*` fields (body parts, background, PAFs)
+	typedef struct OpenPoseHeatmapFrame
+	{
+		unsigned long long frameId;
+		int numberChannels;
+		int height;
+		int width;
+		int format; // OpenPoseHeatmapFormat
+		const void* data;
+		float quantizationScale; // 1 unless format is OPENPOSE_HEATMAP_UINT8
+		float quantizationOffset; // 0 unless format is OPENPOSE_HEATMAP_UINT8
+	} OpenPoseHeatmapFrame;
+
+	// Called with the heat maps of each processed frame, see OpenPoseConfig::heatmapCallback. `frame` and its data are
+	// only valid during the call
+	typedef void (*OpenPoseHeatmapCallback)(const OpenPoseHeatmapFrame* frame, void* userData);
+
+	// Where the frames of a session come from
+	typedef enum OpenPoseInputMode
+	{
+		OPENPOSE_INPUT_PRODUCER = 0, // imageDirectory, video, ipCamera or camera (see the matching gflags)
+		OPENPOSE_INPUT_PUSH = 1, // openPoseSessionPushFrame
+	} OpenPoseInputMode;
+
+	// Body pose inference backend of the batch extractor (openPoseBatchCreate) only. Sessions always run the pose, face
+	// and hand networks on Caffe, through op::Wrapper, and the batch extractor has no face nor hand networks
+	typedef enum OpenPosePoseEngine
+	{
+		OPENPOSE_POSE_ENGINE_CAFFE = 0, // Caffe network (GPU in CUDA builds)
+		OPENPOSE_POSE_ENGINE_OPENCV = 1, // OpenCV dnn module on the CPU (OpenCV 3.3 or later), same prototxt/caffemodel
+		OPENPOSE_POSE_ENGINE_OPENCV_INT8 = 2, // Same, quantized to int8 (OpenCV 4.6 or later), see openPoseCalibrateInt8
+	} OpenPosePoseEngine;
+
+	// Pipeline stages timed by openPoseSessionGetStageStats and openPoseBatchGetStageStats. op::Wrapper runs the input
+	// conversion, the networks (including the heatmap resize, NMS and body part connection), face, hand and rendering
+	// inside its own workers, so sessions time them as a whole (EXTRACTION). The batch extractor times its steps one by
+	// one. Its pose network, resize, NMS and connection all happen in PoseEngine::forwardPass (NETWORK), which the
+	// OpenCV engines and the shared-weight Caffe engine (`batchShareWeights`) also split into NETWORK_FORWARD,
+	// RESIZE_AND_NMS and BODY_PART_CONNECTION (op::PoseExtractorCaffe runs them as a single call, so the default Caffe
+	// engine only reports NETWORK).
+	typedef enum OpenPoseStage
+	{
+		OPENPOSE_STAGE_PRODUCER = 0, // Session: openPoseSessionPushFrame call. Batch: image reading/conversion
+		OPENPOSE_STAGE_INPUT_CONVERSION = 1, // Batch only: scales and cv::Mat to network input
+		OPENPOSE_STAGE_NETWORK = 2, // Batch only: pose network forward pass, resize, NMS and body part connection
+		OPENPOSE_STAGE_KEYPOINT_SCALING = 3, // Batch only
+		OPENPOSE_STAGE_EXTRACTION = 4, // Session only: push until the end of the pose, face, hand and rendering workers
+		OPENPOSE_STAGE_OUTPUT = 5, // Session only: end of extraction until the keypoints are published
+		OPENPOSE_STAGE_TOTAL = 6, // Session: push until publication (push-input only). Batch: per image, after reading
+		OPENPOSE_STAGE_NETWORK_FORWARD = 7, // Batch with OpenCV or shared-weight engine only: forward pass (in NETWORK)
+		OPENPOSE_STAGE_RESIZE_AND_NMS = 8, // Batch with OpenCV or shared-weight engine only: resize and NMS
+		OPENPOSE_STAGE_BODY_PART_CONNECTION = 9, // Batch with OpenCV or shared-weight engine only
+		OPENPOSE_STAGE_COUNT = 10,
+	} OpenPoseStage;
+
+	// Statistics of one stage over its last 1024 frames
+	typedef struct OpenPoseStageStats
+	{
+		unsigned long long count; // Frames timed since creation (not limited to the window)
+		double p50Ms;
+		double p95Ms;
+		double p99Ms;
+		double maxMs;
+	} OpenPoseStageStats;
+
+	// Plain C mirror of op::WrapperStructPose/Face/Hand/Input/Output. Each field matches the gflag of the same meaning
+	// in dllExportFile.cpp (e.g. netInputWidth/netInputHeight <-> `net_resolution`), so fill it with
+	// openPoseConfigDefault and then override the desired fields. Boolean fields are 0/1 ints and null strings are
+	// read as "". The strings are only read during openPoseSessionCreateWithConfig.
+	typedef struct OpenPoseConfig
+	{
+		// Producer
+		int inputMode; // OpenPoseInputMode
+		const char* imageDirectory;
+		const char* video;
+		const char* ipCamera;
+		int camera;
+		int cameraWidth;
+		int cameraHeight;
+		double cameraFps;
+		unsigned long long frameFirst;
+		unsigned long long frameLast;
+		int processRealTime;
+		int frameFlip;
+		int frameRotate;
+		int framesRepeat;
+		// OpenPose
+		const char* modelFolder;
+		int outputWidth;
+		int outputHeight;
+		int numGpu;
+		int numGpuStart;
+		int keypointScale;
+		int identification;
+		// OpenPose Body Pose
+		int bodyEnable;
+		const char* modelPose;
+		int netInputWidth;
+		int netInputHeight;
+		int scaleNumber;
+		double scaleGap;
+		int heatmapsAddParts;
+		int heatmapsAddBkg;
+		int heatmapsAddPAFs;
+		int heatmapsScale; // 0 for [-1, 1], 1 for [0, 1], 2 for [0, 255]
+		int batchPoseEngine; // OpenPosePoseEngine of openPoseBatchCreate, ignored by the sessions
+		const char* int8CalibrationFile; // Written by openPoseCalibrateInt8, read by OPENPOSE_POSE_ENGINE_OPENCV_INT8
+		int batchShareWeights; // See openPoseBatchCreate
+		// OpenPose Face
+		int faceEnable;
+		int faceNetInputWidth;
+		int faceNetInputHeight;
+		// OpenPose Hand
+		int handEnable;
+		int handNetInputWidth;
+		int handNetInputHeight;
+		int handScaleNumber;
+		double handScaleRange;
+		int handTracking;
+		// OpenPose Rendering
+		int partToShow;
+		int disableBlending;
+		double renderThreshold;
+		int renderPose;
+		double alphaPose;
+		double alphaHeatmap;
+		double faceRenderThreshold;
+		int faceRender;
+		double faceAlphaPose;
+		double faceAlphaHeatmap;
+		double handRenderThreshold;
+		int handRender;
+		double handAlphaPose;
+		double handAlphaHeatmap;
+		// Render the keypoints straight into the 8-bit output frame instead of into a float copy of it. It saves two
+		// full-frame conversions and the float frame, at the cost of the GPU-only features (`alpha_X`, heatmaps, i.e.
+		// `partToShow` > 0). Ignored if `renderPose` is 0 and by openPoseDemo
+		int renderUint8;
+		// Display
+		int fullscreen;
+		int guiVerbose;
+		int display;
+		// Result Saving
+		const char* writeImages;
+		const char* writeImagesFormat;
+		const char* writeVideo;
+		const char* writeKeypoint;
+		const char* writeKeypointFormat;
+		const char* writeKeypointJson;
+		const char* writeCocoJson;
+		const char* writeHeatmaps;
+		const char* writeHeatmapsFormat;
+		// Session
+		int disableMultiThread;
+		// Every queue between stages holds one frame. For push input, openPoseSessionPushFrame then never drops the
+		// frame being pushed but the one still waiting to enter the pipeline (its `release` is called, and the push
+		// returns OPENPOSE_FRAME_REPLACED). Only that entry frame is overwritten: the queues between the stages still
+		// block when full, so a frame that entered the pipeline goes through every stage, and a slow stage does not skip
+		// to the newest frame (the stages before it wait instead)
+		int latestFrameOnly;
+		int keypointRingMaxPeople;
+		// Destroyed push-input sessions kept running for reuse (see openPoseReleaseCachedSessions), 0 to disable it. The
+		// value of the session being destroyed applies
+		int sessionCacheSize;
+		// If not null, it is called on an OpenPose thread right after the pose, face and hand stages of each frame,
+		// with `timestampNs` set to the time of the call. It replaces the display and the file writers (the Display and
+		// Result Saving fields are ignored), and it must return quickly, since the next frame waits for it
+		OpenPoseKeypointCallback keypointCallback;
+		void* keypointCallbackUserData;
+		// If not null (and at least one `heatmapsAdd*` field is set), it is called right after keypointCallback with
+		// the body pose heat maps converted to `heatmapFormat` (OpenPoseHeatmapFormat), and the float heat maps are
+		// freed right after. Only the heat maps handed to the host are compact: OpenPose still extracts and carries
+		// them as float until this point. Like keypointCallback, it replaces the display and the file writers
+		OpenPoseHeatmapCallback heatmapCallback;
+		void* heatmapCallbackUserData;
+		int heatmapFormat;
+	} OpenPoseConfig;
+
+	// Blocking demo: it configures the wrapper from the gflags and runs it in the calling thread until the producer is
+	// exhausted
+	OP_DLL_EXPORT int openPoseDemo();
+
+	// Non-blocking session API. Lifecycle: create -> start -> (isRunning)* -> stop -> destroy.
+	// - openPoseSessionCreate configures the wrapper from the gflags. It does not load any network.
+	// - openPoseSessionStart spawns the worker threads and returns immediately. The networks are loaded inside those
+	//   threads, so the calling (host) thread never waits for them.
+	// - openPoseSessionIsRunning is wait-free and can be called every host frame. It returns 1 while running, 0 once the
+	//   producer is exhausted or the session was stopped, and a negative OpenPoseStatus on error.
+	// - openPoseSessionStop joins the worker threads (it waits for the frame being processed, if any).
+	// - openPoseSessionDestroy stops the session if needed and releases it. Null handles are ignored. Once it returns,
+	//   OpenPose no longer reads any frame pushed through the handle (a session kept warm first waits for the frames
+	//   still in flight, see openPoseReleaseCachedSessions), so the host can free them.
+	OP_DLL_EXPORT OpenPoseSession* openPoseSessionCreate();
+	OP_DLL_EXPORT int openPoseSessionStart(OpenPoseSession* session);
+	OP_DLL_EXPORT int openPoseSessionIsRunning(const OpenPoseSession* session);
+	OP_DLL_EXPORT int openPoseSessionStop(OpenPoseSession* session);
+	OP_DLL_EXPORT void openPoseSessionDestroy(OpenPoseSession* session);
+
+	// Push-input sessions: the producer gflags are ignored and the host feeds the frames itself.
+	// openPoseSessionPushFrame never blocks. BGR24 frames are not copied: OpenPose reads `data` in place (it never writes
+	// to it), so the buffer must stay valid and unmodified until `release(userData)` is called. That happens on an
+	// OpenPose thread right after the pose, face and hand stages (and the renderers) are done with the frame. BGRA32
+	// frames are converted to BGR24 during the call, so `release` is called before it returns. `release` can be null and
+	// it is always called exactly once, including when the frame is dropped (OPENPOSE_FRAME_DROPPED, i.e. the input
+	// queue is full) or rejected with an error.
+	// With `latestFrameOnly`, the pushed frame is always accepted. OPENPOSE_FRAME_REPLACED then means that the frame
+	// pushed before it had not entered the pipeline yet and was dropped instead: the `release` of that previous frame
+	// is called during this call, and it never gets keypoints.
+	OP_DLL_EXPORT OpenPoseSession* openPoseSessionCreatePushInput();
+	OP_DLL_EXPORT int openPoseSessionPushFrame(OpenPoseSession* session, const unsigned char* data, int width, int height,
+		int stepBytes, int pixelFormat, OpenPoseFrameReleaseCallback release, void* userData);
+
+	// It copies the latest published keypoints into `frame` without locking nor allocating, so it can be called every
+	// host frame. Compare `frameId` with the previous call to know whether it is a new frame.
+	// Returns 1 if `frame` was filled, 0 if no frame has been processed yet, and a negative OpenPoseStatus on error.
+	// `frame` and its buffers are only written when it returns 1. Call it from one host thread at a time.
+	OP_DLL_EXPORT int openPoseSessionPollKeypoints(const OpenPoseSession* session, OpenPoseKeypointFrame* frame);
+
+	// Struct-based configuration. Sessions created with openPoseSessionCreateWithConfig do not read any gflag, so several
+	// sessions with different configurations (e.g. a push-input session and a video session, or two different models)
+	// can run side by side in the same process.
+	// - openPoseConfigDefault fills `config` with the gflag values (i.e. their defaults unless changed by the host). The
+	//   string fields point to the gflag storage, so they stay valid for the lifetime of the library.
+	// - openPoseSessionCreateWithConfig behaves like openPoseSessionCreate or openPoseSessionCreatePushInput, depending
+	//   on `inputMode`.
+	// - openPoseSetLoggingLevel sets the op::log threshold, [0, 255]. Logging is shared by the whole process, not per
+	//   session.
+	OP_DLL_EXPORT int openPoseConfigDefault(OpenPoseConfig* config);
+	OP_DLL_EXPORT OpenPoseSession* openPoseSessionCreateWithConfig(const OpenPoseConfig* config);
+	OP_DLL_EXPORT int openPoseSetLoggingLevel(int loggingLevel);
+
+	// Batch extraction of still images (body keypoints only), for offline jobs. openPoseBatchCreate loads the pose
+	// network once (asynchronously, on a dedicated engine thread) from the OpenPose and Body Pose fields of `config`;
+	// every openPoseBatchProcess then reuses it. During openPoseBatchProcess, the calling thread reads (or converts)
+	// the next images while the engine thread runs the network on the current one.
+	// Several batches run in parallel (each one on its own engine thread). With `batchShareWeights` (Caffe
+	// `batchPoseEngine` only), the batches with the same model and `numGpuStart` read a single copy of the caffemodel
+	// weights, loaded by the first one and freed with the last one, and each batch only allocates its own activations.
+	// Their network then runs outside op::PoseExtractorCaffe, with the post-processing (resize, NMS and body part
+	// connection) on the CPU, also in CUDA builds. Sessions (op::Wrapper) always load their own weights.
+	typedef struct OpenPoseBatch OpenPoseBatch;
+
+	// One image of a batch: a file path, or a host frame with the same rules as openPoseSessionPushFrame (it is only
+	// read during openPoseBatchProcess)
+	typedef struct OpenPoseImage
+	{
+		const char* path; // If not null, the image is read from this file and the other fields are ignored
+		const unsigned char* data;
+		int width;
+		int height;
+		int stepBytes;
+		int pixelFormat; // OpenPosePixelFormat
+	} OpenPoseImage;
+
+	// `frames` has one host-allocated OpenPoseKeypointFrame per image (see openPoseSessionPollKeypoints), and
+	// `frames[i].frameId` is set to i. It blocks until the whole batch is done.
+	// Returns the number of images successfully processed, or a negative OpenPoseStatus on error. The images that could
+	// not be read or processed get `numberPeople = -1` (and are not counted).
+	OP_DLL_EXPORT OpenPoseBatch* openPoseBatchCreate(const OpenPoseConfig* config);
+	OP_DLL_EXPORT int openPoseBatchProcess(OpenPoseBatch* batch, const OpenPoseImage* images, int numberImages,
+		OpenPoseKeypointFrame* frames);
+	OP_DLL_EXPORT void openPoseBatchDestroy(OpenPoseBatch* batch);
+
+	// Int8 post-training quantization of the OpenCV pose engine (OpenCV 4.6 or later). openPoseCalibrateInt8 writes the
+	// list of the images of `imageDirectory` (e.g. examples/media/), with `modelPose` and the `netInputWidth` x
+	// `netInputHeight` single scale, to `int8CalibrationFile`. It is only a calibration image list, not a quantized
+	// model: OpenCV cannot save a quantized network nor take precomputed activation ranges, so
+	// OPENPOSE_POSE_ENGINE_OPENCV_INT8 runs the calibration over those images (which must still exist) every time
+	// openPoseBatchCreate loads it. openPoseCalibrateInt8 then runs the fp32 and int8 engines over the same images and
+	// fills `report` (also written to `int8CalibrationFile`).
+	// Scope: int8 is only available to openPoseBatchCreate. The sessions, and op::Wrapper (WrapperStructPose), keep the
+	// fp32 Caffe network. The int8 speedup depends on the CPU and OpenCV build and is not guaranteed: `report` measures it
+	// on the calibration machine.
+	typedef struct OpenPoseInt8Report
+	{
+		int numberImages;
+		double fp32MsPerImage; // Network, resize, NMS and body part connection
+		double int8MsPerImage;
+		int fp32People; // People detected over all the images
+		int int8People;
+		double keypointRecall; // Fraction of the fp32 keypoints (score > `renderThreshold`) also found by int8
+		double meanKeypointErrorPixels; // Mean distance of those keypoints to the fp32 ones, in input resolution
+	} OpenPoseInt8Report;
+
+	OP_DLL_EXPORT int openPoseCalibrateInt8(const OpenPoseConfig* config, OpenPoseInt8Report* report);
+
+	// They fill `stageStats` with the statistics of `stage` (OpenPoseStage), 0 for the stages that the session or batch
+	// does not time.
+	OP_DLL_EXPORT int openPoseSessionGetStageStats(const OpenPoseSession* session, int stage,
+		OpenPoseStageStats* stageStats);
+	OP_DLL_EXPORT int openPoseBatchGetStageStats(const OpenPoseBatch* batch, int stage, OpenPoseStageStats* stageStats);
+
+	// Process-wide pool of the full-frame buffers allocated on every frame (converted BGRA frames, multi-scale pyramid
+	// levels, `renderUint8` output frames). Once the frame size is stable, every request should be a hit.
+	typedef struct OpenPoseBufferPoolStats
+	{
+		unsigned long long hits; // Requests served with a recycled buffer
+		unsigned long long misses; // Requests that allocated a new buffer
+		unsigned long long idleBytes; // Memory currently kept for reuse
+	} OpenPoseBufferPoolStats;
+
+	OP_DLL_EXPORT int openPoseGetBufferPoolStats(OpenPoseBufferPoolStats* bufferPoolStats);
+
+	// Process-wide copy counters of the session pipelines, which should stay at 0: the frames are moved between the
+	// stages and the pushed BGR24 frames are read in place. Debug builds also log the first copy of each kind.
+	typedef struct OpenPoseCopyStats
+	{
+		unsigned long long datumCopies; // Frame records copied instead of moved between stages
+		unsigned long long payloadCopies; // Full copies of a frame image (e.g. a pushed frame copied by a worker)
+		unsigned long long payloadBytes; // Bytes of those copies
+	} OpenPoseCopyStats;
+
+	OP_DLL_EXPORT int openPoseGetCopyStats(OpenPoseCopyStats* copyStats);
+
+	// Warm restarts: destroying a push-input session that is still running (i.e. not stopped) keeps it alive in a
+	// process-wide cache (`sessionCacheSize` field), with its networks loaded. The next openPoseSessionCreatePushInput
+	// with the same configuration gets it back already started, instead of reloading the models.
+	// openPoseReleaseCachedSessions stops and frees the cached sessions, and frees the idle buffers of the buffer pool.
+	// Call it before unloading the library.
+	OP_DLL_EXPORT void openPoseReleaseCachedSessions();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OPENPOSE_EXAMPLES_TUTORIAL_POSE_DLL_EXPORT_FILE_HPP
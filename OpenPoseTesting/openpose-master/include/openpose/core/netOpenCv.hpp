@@ -0,0 +1,53 @@
+#ifndef OPENPOSE_CORE_NET_OPEN_CV_HPP
+#define OPENPOSE_CORE_NET_OPEN_CV_HPP
+
+#include <memory> // std::unique_ptr
+#include <string>
+#include <vector>
+#include <opencv2/core/core.hpp> // cv::Mat
+#include <openpose/core/common.hpp>
+#include <openpose/core/net.hpp>
+
+namespace op
+{
+    /**
+     * NetOpenCv: Net implementation that runs the same prototxt and caffemodel as NetCaffe through the OpenCV dnn
+     * module (OpenCV 3.3 or later), on the CPU. Its optimized convolutions are much faster than the Caffe im2col + GEMM
+     * path on machines without GPU.
+     * It mirrors the NetCaffe interface, with getOutputBlob() returning the output as a 4-D cv::Mat ({number scales,
+     * channels, height, width}, valid until the next forwardPass()) instead of a caffe::Blob.
+     */
+    class OP_API NetOpenCv : public Net
+    {
+    public:
+        NetOpenCv(const std::string& caffeProto, const std::string& caffeTrainedModel,
+                  const std::string& lastBlobName = "net_output");
+
+        virtual ~NetOpenCv();
+
+        void initializationOnThread();
+
+        /**
+         * Int8 post-training quantization (OpenCV 4.6 or later): it replaces the loaded network by its int8 version,
+         * whose activation ranges are measured on `calibrationInputs` (each one with the forwardPass() input layout).
+         * Inputs and outputs stay in float. It must be called after initializationOnThread().
+         * OpenCV can neither save the quantized network nor import activation ranges, so every NetOpenCv instance must
+         * be quantized again from its calibration inputs.
+         */
+        void quantize(const std::vector<Array<float>>& calibrationInputs);
+
+        void forwardPass(const Array<float>& inputNetData) const;
+
+        cv::Mat getOutputBlob() const;
+
+    private:
+        // PIMPL idiom
+        // http://www.cppsamples.com/common-tasks/pimpl.html
+        struct ImplNetOpenCv;
+        std::unique_ptr<ImplNetOpenCv> upImpl;
+
+        DELETE_COPY(NetOpenCv);
+    };
+}
+
+#endif // OPENPOSE_CORE_NET_OPEN_CV_HPP
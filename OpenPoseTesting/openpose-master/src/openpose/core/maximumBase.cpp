@@ -0,0 +1,155 @@
+#ifdef __AVX__
+    #include <immintrin.h>
+#elif defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+#include <openpose/utilities/errorAndLog.hpp>
+#include <openpose/core/maximumBase.hpp>
+
+namespace op
+{
+    template <typename T>
+    void argMaxScalar(int& maximumIndex, T& maximumValue, const T* const sourcePtr, const int size)
+    {
+        maximumIndex = 0;
+        maximumValue = sourcePtr[0];
+        for (auto i = 1 ; i < size ; i++)
+        {
+            if (sourcePtr[i] > maximumValue)
+            {
+                maximumIndex = i;
+                maximumValue = sourcePtr[i];
+            }
+        }
+    }
+
+    // First (in memory order) maximum of sourcePtr[0, size): its index and value
+    template <typename T>
+    void argMax(int& maximumIndex, T& maximumValue, const T* const sourcePtr, const int size)
+    {
+        argMaxScalar(maximumIndex, maximumValue, sourcePtr, size);
+    }
+
+    #if defined(__AVX__) || defined(__SSE2__)
+        // Each lane keeps the first maximum of its own elements (indexes kept as floats, exact up to 2^24 pixels), then
+        // the lanes are merged (greatest value, lowest index on ties), so the result matches the scalar scan
+        template <>
+        void argMax(int& maximumIndex, float& maximumValue, const float* const sourcePtr, const int size)
+        {
+            #ifdef __AVX__
+                const auto numberLanes = 8;
+            #else
+                const auto numberLanes = 4;
+            #endif
+            if (size < 2 * numberLanes)
+            {
+                argMaxScalar(maximumIndex, maximumValue, sourcePtr, size);
+                return;
+            }
+            float laneValues[numberLanes];
+            float laneIndexes[numberLanes];
+            auto i = numberLanes;
+            #ifdef __AVX__
+                auto maximumValues = _mm256_loadu_ps(sourcePtr);
+                auto maximumIndexes = _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f);
+                auto indexes = maximumIndexes;
+                const auto step = _mm256_set1_ps(8.f);
+                for ( ; i + numberLanes <= size ; i += numberLanes)
+                {
+                    indexes = _mm256_add_ps(indexes, step);
+                    const auto values = _mm256_loadu_ps(sourcePtr + i);
+                    const auto isGreater = _mm256_cmp_ps(values, maximumValues, _CMP_GT_OQ);
+                    maximumValues = _mm256_blendv_ps(maximumValues, values, isGreater);
+                    maximumIndexes = _mm256_blendv_ps(maximumIndexes, indexes, isGreater);
+                }
+                _mm256_storeu_ps(laneValues, maximumValues);
+                _mm256_storeu_ps(laneIndexes, maximumIndexes);
+            #else
+                auto maximumValues = _mm_loadu_ps(sourcePtr);
+                auto maximumIndexes = _mm_setr_ps(0.f, 1.f, 2.f, 3.f);
+                auto indexes = maximumIndexes;
+                const auto step = _mm_set1_ps(4.f);
+                for ( ; i + numberLanes <= size ; i += numberLanes)
+                {
+                    indexes = _mm_add_ps(indexes, step);
+                    const auto values = _mm_loadu_ps(sourcePtr + i);
+                    const auto isGreater = _mm_cmpgt_ps(values, maximumValues);
+                    // No blendv in SSE2
+                    maximumValues = _mm_or_ps(_mm_and_ps(isGreater, values), _mm_andnot_ps(isGreater, maximumValues));
+                    maximumIndexes = _mm_or_ps(_mm_and_ps(isGreater, indexes),
+                                               _mm_andnot_ps(isGreater, maximumIndexes));
+                }
+                _mm_storeu_ps(laneValues, maximumValues);
+                _mm_storeu_ps(laneIndexes, maximumIndexes);
+            #endif
+            maximumValue = laneValues[0];
+            maximumIndex = (int)laneIndexes[0];
+            for (auto lane = 1 ; lane < numberLanes ; lane++)
+            {
+                if (laneValues[lane] > maximumValue
+                    || (laneValues[lane] == maximumValue && (int)laneIndexes[lane] < maximumIndex))
+                {
+                    maximumValue = laneValues[lane];
+                    maximumIndex = (int)laneIndexes[lane];
+                }
+            }
+            // Remainder, after every lane element
+            for ( ; i < size ; i++)
+            {
+                if (sourcePtr[i] > maximumValue)
+                {
+                    maximumIndex = i;
+                    maximumValue = sourcePtr[i];
+                }
+            }
+        }
+    #endif
+
+    template <typename T>
+    void maximumCpu(T* targetPtr, const T* const sourcePtr, const std::array<int, 4>& targetSize,
+                    const std::array<int, 4>& sourceSize)
+    {
+        try
+        {
+            // Params
+            const auto num = targetSize[0]; // People (one face or hand crop each)
+            const auto channels = targetSize[1]; // Face or hand keypoints (without background)
+            const auto height = sourceSize[2];
+            const auto width = sourceSize[3];
+            const auto sourceChannelOffset = width * height;
+            // Security checks
+            if (targetSize[2] != 3)
+                error("The target must be (x, y, score) triplets.", __LINE__, __FUNCTION__, __FILE__);
+            if (num != sourceSize[0] || channels > sourceSize[1])
+                error("Target and source sizes do not match.", __LINE__, __FUNCTION__, __FILE__);
+            if (sourceChannelOffset < 1)
+                error("Empty source.", __LINE__, __FUNCTION__, __FILE__);
+
+            // Every channel of every person in a single parallel loop (e.g. 5 faces = 350 independent scans, rather
+            // than 5 sequential rounds of 70)
+            #pragma omp parallel for
+            for (auto index = 0 ; index < num * channels ; index++)
+            {
+                const auto n = index / channels;
+                const auto c = index % channels;
+                int maximumIndex;
+                T maximumValue;
+                argMax(maximumIndex, maximumValue, sourcePtr + (n * sourceSize[1] + c) * sourceChannelOffset,
+                       sourceChannelOffset);
+                auto* targetKeypointPtr = targetPtr + 3 * index;
+                targetKeypointPtr[0] = T(maximumIndex % width);
+                targetKeypointPtr[1] = T(maximumIndex / width);
+                targetKeypointPtr[2] = maximumValue;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template void maximumCpu(float* targetPtr, const float* const sourcePtr, const std::array<int, 4>& targetSize,
+                             const std::array<int, 4>& sourceSize);
+    template void maximumCpu(double* targetPtr, const double* const sourcePtr, const std::array<int, 4>& targetSize,
+                             const std::array<int, 4>& sourceSize);
+}
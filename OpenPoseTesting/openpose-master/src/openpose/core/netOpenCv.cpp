@@ -0,0 +1,151 @@
+// USE_OPENCV_DNN: the dnn module (OpenCV 3.3 or later) reads Caffe models. cv::dnn::Net::quantize exists since
+// OpenCV 4.6
+#ifdef USE_OPENCV_DNN
+    #include <opencv2/core/version.hpp>
+    #include <opencv2/dnn.hpp>
+    #define OPENPOSE_OPENCV_DNN
+    #if CV_MAJOR_VERSION > 4 || (CV_MAJOR_VERSION == 4 && CV_MINOR_VERSION >= 6)
+        #define OPENPOSE_OPENCV_DNN_INT8
+    #endif
+#endif
+#include <openpose/core/macros.hpp>
+#include <openpose/utilities/errorAndLog.hpp>
+#include <openpose/core/netOpenCv.hpp>
+
+namespace op
+{
+    struct NetOpenCv::ImplNetOpenCv
+    {
+        // Init with constructor
+        const std::string mCaffeProto;
+        const std::string mCaffeTrainedModel;
+        const std::string mLastBlobName;
+        #ifdef OPENPOSE_OPENCV_DNN
+            // Init with thread
+            cv::dnn::Net mNet;
+            cv::Mat mOutputBlob;
+        #endif
+
+        ImplNetOpenCv(const std::string& caffeProto, const std::string& caffeTrainedModel,
+                      const std::string& lastBlobName) :
+            mCaffeProto{caffeProto},
+            mCaffeTrainedModel{caffeTrainedModel},
+            mLastBlobName{lastBlobName}
+        {
+        }
+    };
+
+    // The 4-D cv::Mat header of a {number scales, 3, height, width} array, without copying its data
+    cv::Mat arrayToOpenCvBlob(const Array<float>& array)
+    {
+        if (array.getNumberDimensions() != 4)
+            error("The network input must be {number scales, 3, height, width}.", __LINE__, __FUNCTION__, __FILE__);
+        const int sizes[4]{array.getSize(0), array.getSize(1), array.getSize(2), array.getSize(3)};
+        return cv::Mat{4, sizes, CV_32FC1, const_cast<float*>(array.getConstPtr())};
+    }
+
+    NetOpenCv::NetOpenCv(const std::string& caffeProto, const std::string& caffeTrainedModel,
+                         const std::string& lastBlobName) :
+        upImpl{new ImplNetOpenCv{caffeProto, caffeTrainedModel, lastBlobName}}
+    {
+        try
+        {
+            #ifndef OPENPOSE_OPENCV_DNN
+                error("OpenPose must be compiled with the `USE_OPENCV_DNN` macro definition (OpenCV 3.3 or later) in"
+                      " order to use NetOpenCv.", __LINE__, __FUNCTION__, __FILE__);
+            #endif
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    NetOpenCv::~NetOpenCv()
+    {
+    }
+
+    void NetOpenCv::initializationOnThread()
+    {
+        try
+        {
+            #ifdef OPENPOSE_OPENCV_DNN
+                upImpl->mNet = cv::dnn::readNetFromCaffe(upImpl->mCaffeProto, upImpl->mCaffeTrainedModel);
+                if (upImpl->mNet.empty())
+                    error("The network could not be read from " + upImpl->mCaffeProto + " and "
+                          + upImpl->mCaffeTrainedModel + ".", __LINE__, __FUNCTION__, __FILE__);
+                upImpl->mNet.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+            #endif
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    void NetOpenCv::quantize(const std::vector<Array<float>>& calibrationInputs)
+    {
+        try
+        {
+            #ifdef OPENPOSE_OPENCV_DNN_INT8
+                if (calibrationInputs.empty())
+                    error("Int8 quantization requires at least one calibration input.",
+                          __LINE__, __FUNCTION__, __FILE__);
+                std::vector<cv::Mat> calibrationBlobs;
+                calibrationBlobs.reserve(calibrationInputs.size());
+                for (const auto& calibrationInput : calibrationInputs)
+                    calibrationBlobs.emplace_back(arrayToOpenCvBlob(calibrationInput));
+                upImpl->mNet = upImpl->mNet.quantize(calibrationBlobs, CV_32F, CV_32F);
+                // The quantized layers are only implemented by the OpenCV backend
+                upImpl->mNet.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+                upImpl->mNet.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+            #else
+                UNUSED(calibrationInputs);
+                error("Int8 quantization requires OpenCV 4.6 or later (cv::dnn::Net::quantize).",
+                      __LINE__, __FUNCTION__, __FILE__);
+            #endif
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    void NetOpenCv::forwardPass(const Array<float>& inputNetData) const
+    {
+        try
+        {
+            #ifdef OPENPOSE_OPENCV_DNN
+                // Security checks
+                if (inputNetData.empty())
+                    error("The Array inputNetData cannot be empty.", __LINE__, __FUNCTION__, __FILE__);
+                // The input array is read in place
+                upImpl->mNet.setInput(arrayToOpenCvBlob(inputNetData));
+                upImpl->mOutputBlob = upImpl->mNet.forward(upImpl->mLastBlobName);
+            #else
+                UNUSED(inputNetData);
+            #endif
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    cv::Mat NetOpenCv::getOutputBlob() const
+    {
+        try
+        {
+            #ifdef OPENPOSE_OPENCV_DNN
+                return upImpl->mOutputBlob;
+            #else
+                return cv::Mat{};
+            #endif
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+            return cv::Mat{};
+        }
+    }
+}
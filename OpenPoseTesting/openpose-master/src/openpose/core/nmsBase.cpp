@@ -0,0 +1,190 @@
+#include <algorithm> // std::max, std::min
+#include <vector>
+#ifdef __AVX__
+    #include <immintrin.h>
+#elif defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+#include <openpose/core/macros.hpp>
+#include <openpose/utilities/errorAndLog.hpp>
+#include <openpose/core/nmsBase.hpp>
+
+namespace op
+{
+    // Peak test of any pixel (border ones included): above threshold and strictly greater than its in-bounds 3x3
+    // neighbours
+    template <typename T>
+    bool isPeak(const T* const sourcePtr, const int x, const int y, const int width, const int height,
+                const T threshold)
+    {
+        const auto value = sourcePtr[y*width + x];
+        if (value <= threshold)
+            return false;
+        for (auto dy = -1 ; dy <= 1 ; dy++)
+        {
+            const auto yNeighbour = y + dy;
+            if (0 <= yNeighbour && yNeighbour < height)
+            {
+                for (auto dx = -1 ; dx <= 1 ; dx++)
+                {
+                    const auto xNeighbour = x + dx;
+                    if ((dx != 0 || dy != 0) && 0 <= xNeighbour && xNeighbour < width
+                        && value <= sourcePtr[yNeighbour*width + xNeighbour])
+                        return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // It writes the peak (x, y, score) into peakPtr, with the location refined to subpixel precision by the
+    // score-weighted average of its 7x7 neighbourhood (as the CUDA kernel)
+    template <typename T>
+    void writePeak(T* peakPtr, const T* const sourcePtr, const int x, const int y, const int width, const int height)
+    {
+        T xAcc = 0;
+        T yAcc = 0;
+        T scoreAcc = 0;
+        for (auto yNeighbour = std::max(0, y-3) ; yNeighbour <= std::min(height-1, y+3) ; yNeighbour++)
+        {
+            for (auto xNeighbour = std::max(0, x-3) ; xNeighbour <= std::min(width-1, x+3) ; xNeighbour++)
+            {
+                const auto score = sourcePtr[yNeighbour*width + xNeighbour];
+                if (score > 0)
+                {
+                    xAcc += xNeighbour*score;
+                    yAcc += yNeighbour*score;
+                    scoreAcc += score;
+                }
+            }
+        }
+        peakPtr[0] = xAcc / scoreAcc;
+        peakPtr[1] = yAcc / scoreAcc;
+        peakPtr[2] = sourcePtr[y*width + x];
+    }
+
+    // Bit mask of the peaks among the 8 (AVX) or 4 (SSE2) interior pixels starting at rowPtr[x] (0 if not vectorized)
+    template <typename T>
+    int getPeakMask(const T* const, const int, const int, const T)
+    {
+        return 0;
+    }
+
+    #if defined(__AVX__) || defined(__SSE2__)
+        template <>
+        int getPeakMask(const float* const rowPtr, const int x, const int width, const float threshold)
+        {
+            #ifdef __AVX__
+                const auto* const centerPtr = rowPtr + x;
+                const auto center = _mm256_loadu_ps(centerPtr);
+                auto mask = _mm256_cmp_ps(center, _mm256_set1_ps(threshold), _CMP_GT_OQ);
+                // Most of the heatmap is below threshold
+                if (_mm256_movemask_ps(mask) == 0)
+                    return 0;
+                for (const auto offset : {-width-1, -width, -width+1, -1, 1, width-1, width, width+1})
+                    mask = _mm256_and_ps(mask, _mm256_cmp_ps(center, _mm256_loadu_ps(centerPtr + offset), _CMP_GT_OQ));
+                return _mm256_movemask_ps(mask);
+            #else
+                const auto* const centerPtr = rowPtr + x;
+                const auto center = _mm_loadu_ps(centerPtr);
+                auto mask = _mm_cmpgt_ps(center, _mm_set1_ps(threshold));
+                // Most of the heatmap is below threshold
+                if (_mm_movemask_ps(mask) == 0)
+                    return 0;
+                for (const auto offset : {-width-1, -width, -width+1, -1, 1, width-1, width, width+1})
+                    mask = _mm_and_ps(mask, _mm_cmpgt_ps(center, _mm_loadu_ps(centerPtr + offset)));
+                return _mm_movemask_ps(mask);
+            #endif
+        }
+    #endif
+
+    template <typename T>
+    int getPeakMaskWidth()
+    {
+        return 0;
+    }
+
+    #if defined(__AVX__) || defined(__SSE2__)
+        template <>
+        int getPeakMaskWidth<float>()
+        {
+            #ifdef __AVX__
+                return 8;
+            #else
+                return 4;
+            #endif
+        }
+    #endif
+
+    template <typename T>
+    void nmsCpu(T* targetPtr, int* kernelPtr, const T* const sourcePtr, const T threshold,
+                const std::array<int, 4>& targetSize, const std::array<int, 4>& sourceSize)
+    {
+        try
+        {
+            // kernelPtr is the intermediate peak buffer of the GPU version, the CPU one writes the peaks directly
+            UNUSED(kernelPtr);
+
+            // Params
+            const auto num = targetSize[0];
+            const auto channels = targetSize[1]; // Body parts (without background)
+            const auto maxPeaks = targetSize[2] - 1;
+            const auto height = sourceSize[2];
+            const auto width = sourceSize[3];
+            const auto sourceChannelOffset = width * height;
+            const auto targetChannelOffset = targetSize[2] * targetSize[3];
+            const auto maskWidth = getPeakMaskWidth<T>();
+            // Security checks
+            if (targetSize[3] != 3)
+                error("The target must be (x, y, score) triplets.", __LINE__, __FUNCTION__, __FILE__);
+            if (num != sourceSize[0] || channels > sourceSize[1])
+                error("Target and source sizes do not match.", __LINE__, __FUNCTION__, __FILE__);
+
+            // Channels split across threads. Each channel writes its peaks straight into its own target block, with the
+            // layout that bodyPartConnector reads: the number of peaks first, then one (x, y, score) row per peak.
+            #pragma omp parallel for schedule(dynamic)
+            for (auto index = 0 ; index < num * channels ; index++)
+            {
+                const auto n = index / channels;
+                const auto c = index % channels;
+                const auto* const sourceChannelPtr = sourcePtr + (n * sourceSize[1] + c) * sourceChannelOffset;
+                auto* targetChannelPtr = targetPtr + index * targetChannelOffset;
+                auto numberPeaks = 0;
+                for (auto y = 0 ; y < height && numberPeaks < maxPeaks ; y++)
+                {
+                    const auto* const rowPtr = sourceChannelPtr + y * width;
+                    const auto isInteriorRow = (0 < y && y < height - 1);
+                    auto x = 0;
+                    // Interior pixels: 3x3 test of maskWidth pixels per vector compare
+                    if (isInteriorRow && maskWidth > 0)
+                    {
+                        if (isPeak(sourceChannelPtr, 0, y, width, height, threshold))
+                            writePeak(targetChannelPtr + 3 * (++numberPeaks), sourceChannelPtr, 0, y, width, height);
+                        for (x = 1 ; x + maskWidth < width && numberPeaks < maxPeaks ; x += maskWidth)
+                        {
+                            auto mask = getPeakMask(rowPtr, x, width, threshold);
+                            for (auto lane = 0 ; mask != 0 && numberPeaks < maxPeaks ; lane++, mask >>= 1)
+                                if (mask & 1)
+                                    writePeak(targetChannelPtr + 3 * (++numberPeaks), sourceChannelPtr, x + lane, y,
+                                              width, height);
+                        }
+                    }
+                    // Border pixels and remainder of the row
+                    for ( ; x < width && numberPeaks < maxPeaks ; x++)
+                        if (isPeak(sourceChannelPtr, x, y, width, height, threshold))
+                            writePeak(targetChannelPtr + 3 * (++numberPeaks), sourceChannelPtr, x, y, width, height);
+                }
+                targetChannelPtr[0] = T(numberPeaks);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template void nmsCpu(float* targetPtr, int* kernelPtr, const float* const sourcePtr, const float threshold,
+                         const std::array<int, 4>& targetSize, const std::array<int, 4>& sourceSize);
+    template void nmsCpu(double* targetPtr, int* kernelPtr, const double* const sourcePtr, const double threshold,
+                         const std::array<int, 4>& targetSize, const std::array<int, 4>& sourceSize);
+}
@@ -0,0 +1,246 @@
+#include <algorithm> // std::max, std::min
+#include <vector>
+#ifdef __AVX__
+    #include <immintrin.h>
+#elif defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+#include <openpose/utilities/errorAndLog.hpp>
+#include <openpose/core/resizeAndMergeBase.hpp>
+
+namespace op
+{
+    // Linear interpolation table of one axis: target pixel i samples source pixels indexes[i] and nextIndexes[i], with
+    // weight weights[i] for the second one. Pixel centers are aligned (same mapping than the CUDA kernels) and the
+    // samples outside the source are clamped to its borders.
+    template <typename T>
+    struct InterpolationTable
+    {
+        std::vector<int> indexes;
+        std::vector<int> nextIndexes;
+        std::vector<T> weights;
+
+        InterpolationTable(const int targetLength, const int sourceLength, const T ratio) :
+            indexes(targetLength),
+            nextIndexes(targetLength),
+            weights(targetLength)
+        {
+            for (auto i = 0 ; i < targetLength ; i++)
+            {
+                const auto sourceCoordinate = std::max(T(0), (i + T(0.5)) * ratio - T(0.5));
+                const auto index = std::min((int)sourceCoordinate, sourceLength - 1);
+                indexes[i] = index;
+                nextIndexes[i] = std::min(index + 1, sourceLength - 1);
+                weights[i] = (index < sourceLength - 1 ? sourceCoordinate - index : T(0));
+            }
+        }
+    };
+
+    // Horizontal pass: one source row resized to the target width
+    template <typename T>
+    void resizeRow(T* targetRow, const T* const sourceRow, const InterpolationTable<T>& xTable)
+    {
+        const auto targetWidth = (int)xTable.indexes.size();
+        for (auto x = 0 ; x < targetWidth ; x++)
+        {
+            const auto value = sourceRow[xTable.indexes[x]];
+            targetRow[x] = value + xTable.weights[x] * (sourceRow[xTable.nextIndexes[x]] - value);
+        }
+    }
+
+    template <>
+    void resizeRow(float* targetRow, const float* const sourceRow, const InterpolationTable<float>& xTable)
+    {
+        const auto targetWidth = (int)xTable.indexes.size();
+        auto x = 0;
+        // The source pixels are not contiguous, so only AVX2 (gather) vectorizes this pass. Without it, the compiler
+        // cannot do much better than the scalar loop below, whose 2 loads per pixel hit the same (cached) source row
+        #ifdef __AVX2__
+            for ( ; x + 8 <= targetWidth ; x += 8)
+            {
+                const auto value0 = _mm256_i32gather_ps(sourceRow, _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(xTable.indexes.data() + x)), 4);
+                const auto value1 = _mm256_i32gather_ps(sourceRow, _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(xTable.nextIndexes.data() + x)), 4);
+                _mm256_storeu_ps(targetRow + x, _mm256_add_ps(value0, _mm256_mul_ps(
+                    _mm256_loadu_ps(xTable.weights.data() + x), _mm256_sub_ps(value1, value0))));
+            }
+        #endif
+        for ( ; x < targetWidth ; x++)
+        {
+            const auto value = sourceRow[xTable.indexes[x]];
+            targetRow[x] = value + xTable.weights[x] * (sourceRow[xTable.nextIndexes[x]] - value);
+        }
+    }
+
+    // Vertical pass, fused with the multi-scale average:
+    // targetRow (=, or += if accumulate) scaleWeight * (row0 + yWeight * (row1 - row0))
+    template <typename T>
+    void blendRows(T* targetRow, const T* const row0, const T* const row1, const int width, const T yWeight,
+                   const T scaleWeight, const bool accumulate)
+    {
+        for (auto x = 0 ; x < width ; x++)
+        {
+            const auto value = scaleWeight * (row0[x] + yWeight * (row1[x] - row0[x]));
+            targetRow[x] = (accumulate ? targetRow[x] + value : value);
+        }
+    }
+
+    template <>
+    void blendRows(float* targetRow, const float* const row0, const float* const row1, const int width,
+                   const float yWeight, const float scaleWeight, const bool accumulate)
+    {
+        auto x = 0;
+        #ifdef __AVX__
+            const auto yWeights = _mm256_set1_ps(yWeight);
+            const auto scaleWeights = _mm256_set1_ps(scaleWeight);
+            for ( ; x + 8 <= width ; x += 8)
+            {
+                const auto value0 = _mm256_loadu_ps(row0 + x);
+                auto value = _mm256_mul_ps(scaleWeights, _mm256_add_ps(value0, _mm256_mul_ps(yWeights,
+                    _mm256_sub_ps(_mm256_loadu_ps(row1 + x), value0))));
+                if (accumulate)
+                    value = _mm256_add_ps(_mm256_loadu_ps(targetRow + x), value);
+                _mm256_storeu_ps(targetRow + x, value);
+            }
+        #elif defined(__SSE2__)
+            const auto yWeights = _mm_set1_ps(yWeight);
+            const auto scaleWeights = _mm_set1_ps(scaleWeight);
+            for ( ; x + 4 <= width ; x += 4)
+            {
+                const auto value0 = _mm_loadu_ps(row0 + x);
+                auto value = _mm_mul_ps(scaleWeights, _mm_add_ps(value0, _mm_mul_ps(yWeights,
+                    _mm_sub_ps(_mm_loadu_ps(row1 + x), value0))));
+                if (accumulate)
+                    value = _mm_add_ps(_mm_loadu_ps(targetRow + x), value);
+                _mm_storeu_ps(targetRow + x, value);
+            }
+        #endif
+        for ( ; x < width ; x++)
+        {
+            const auto value = scaleWeight * (row0[x] + yWeight * (row1[x] - row0[x]));
+            targetRow[x] = (accumulate ? targetRow[x] + value : value);
+        }
+    }
+
+    // The 2 last horizontally resized rows of one scale. The target rows are processed in increasing order, so each
+    // source row is resized once per channel (rather than once per target row, i.e. ~8 times for the net stride).
+    template <typename T>
+    class ResizedRowCache
+    {
+    public:
+        ResizedRowCache() :
+            mSourceRows{-1, -1}
+        {
+        }
+
+        // It only reallocates if width grows
+        void reset(const int width)
+        {
+            mRows[0].resize(width);
+            mRows[1].resize(width);
+            mSourceRows[0] = -1;
+            mSourceRows[1] = -1;
+        }
+
+        // It returns the resized sourceRow, never overwriting the one of keptSourceRow
+        const T* getRow(const int sourceRow, const int keptSourceRow, const T* const sourcePtr, const int sourceWidth,
+                        const InterpolationTable<T>& xTable)
+        {
+            for (auto i = 0 ; i < 2 ; i++)
+                if (mSourceRows[i] == sourceRow)
+                    return mRows[i].data();
+            const auto i = (mSourceRows[0] == keptSourceRow ? 1 : 0);
+            resizeRow(mRows[i].data(), sourcePtr + sourceRow * sourceWidth, xTable);
+            mSourceRows[i] = sourceRow;
+            return mRows[i].data();
+        }
+
+    private:
+        std::vector<T> mRows[2];
+        int mSourceRows[2];
+    };
+
+    template <typename T>
+    void resizeAndMergeCpu(T* targetPtr, const T* const sourcePtr, const std::array<int, 4>& targetSize,
+                           const std::array<int, 4>& sourceSize, const std::vector<T>& scaleInputToNetInputs)
+    {
+        try
+        {
+            // Params
+            const auto numberScales = sourceSize[0];
+            const auto channels = targetSize[1]; // 57
+            const auto targetHeight = targetSize[2]; // 368
+            const auto targetWidth = targetSize[3]; // 496
+            const auto targetChannelOffset = targetWidth * targetHeight;
+            const auto sourceHeight = sourceSize[2];
+            const auto sourceWidth = sourceSize[3];
+            const auto sourceChannelOffset = sourceWidth * sourceHeight;
+            // Security checks
+            if (targetSize[0] != 1 || sourceSize[1] != channels)
+                error("The target must be a single blob with the source number of channels.",
+                      __LINE__, __FUNCTION__, __FILE__);
+            if (numberScales > 1 && (int)scaleInputToNetInputs.size() != numberScales)
+                error("scaleInputToNetInputs must have one element per scale.", __LINE__, __FUNCTION__, __FILE__);
+
+            // Interpolation tables, shared by every channel. Scale 0 defines the target resolution (net input
+            // resolution), while the smaller scales only fill the top-left part of the padded net input, so target
+            // pixel x maps to source pixel (x+0.5) * (scale_n/scale_0) * (sourceWidth/targetWidth) - 0.5
+            std::vector<InterpolationTable<T>> xTables;
+            std::vector<InterpolationTable<T>> yTables;
+            xTables.reserve(numberScales);
+            yTables.reserve(numberScales);
+            for (auto n = 0 ; n < numberScales ; n++)
+            {
+                const auto scaleRatio = (numberScales > 1
+                    ? scaleInputToNetInputs[n] / scaleInputToNetInputs[0] : T(1));
+                xTables.emplace_back(targetWidth, sourceWidth, scaleRatio * sourceWidth / T(targetWidth));
+                yTables.emplace_back(targetHeight, sourceHeight, scaleRatio * sourceHeight / T(targetHeight));
+            }
+            const auto scaleWeight = T(1) / numberScales;
+
+            // Channels split across threads. Each target row is written by every scale while it is in cache, so the
+            // multi-scale average needs neither temporary targets nor a final pass.
+            #pragma omp parallel
+            {
+                // Kept across calls: the OpenMP threads are pooled, so after the first frame no row is reallocated
+                static thread_local std::vector<ResizedRowCache<T>> rowCaches;
+                if ((int)rowCaches.size() < numberScales)
+                    rowCaches.resize(numberScales);
+                #pragma omp for schedule(dynamic)
+                for (auto c = 0 ; c < channels ; c++)
+                {
+                    for (auto n = 0 ; n < numberScales ; n++)
+                        rowCaches[n].reset(targetWidth);
+                    auto* targetChannelPtr = targetPtr + c * targetChannelOffset;
+                    for (auto y = 0 ; y < targetHeight ; y++)
+                    {
+                        auto* targetRow = targetChannelPtr + y * targetWidth;
+                        for (auto n = 0 ; n < numberScales ; n++)
+                        {
+                            const auto* sourceChannelPtr = sourcePtr + (n * channels + c) * sourceChannelOffset;
+                            const auto sourceRow0 = yTables[n].indexes[y];
+                            const auto sourceRow1 = yTables[n].nextIndexes[y];
+                            const auto* row0 = rowCaches[n].getRow(sourceRow0, sourceRow1, sourceChannelPtr,
+                                                                   sourceWidth, xTables[n]);
+                            const auto* row1 = rowCaches[n].getRow(sourceRow1, sourceRow0, sourceChannelPtr,
+                                                                   sourceWidth, xTables[n]);
+                            blendRows(targetRow, row0, row1, targetWidth, yTables[n].weights[y], scaleWeight, n > 0);
+                        }
+                    }
+                }
+            }
+        }
+        catch (const std::exception& e)
+        {
+            error(e.what(), __LINE__, __FUNCTION__, __FILE__);
+        }
+    }
+
+    template void resizeAndMergeCpu(float* targetPtr, const float* const sourcePtr,
+                                    const std::array<int, 4>& targetSize, const std::array<int, 4>& sourceSize,
+                                    const std::vector<float>& scaleInputToNetInputs);
+    template void resizeAndMergeCpu(double* targetPtr, const double* const sourcePtr,
+                                    const std::array<int, 4>& targetSize, const std::array<int, 4>& sourceSize,
+                                    const std::vector<double>& scaleInputToNetInputs);
+}